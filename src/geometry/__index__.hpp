@@ -10,4 +10,5 @@ Central import for all files in /geometry.
 #include "mappings.hpp"
 #include "morphisms.hpp"
 #include "polygon_properties.hpp"
+#include "rasterisation.hpp"
 #include "triangle_centers.hpp"
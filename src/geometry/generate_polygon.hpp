@@ -5,38 +5,60 @@ Functions for generating polygons.
 #pragma once
 
 // core
-#include <algorithm>	// generate, min, max, shuffle, sort
+#include <algorithm>	// generate, min, max, nth_element, reverse, shuffle, sort
+#include <functional>	// hash
 #include <limits>		// numeric_limits
 #include <math.h>		// abs
-#include <random>		// default_random_engine
-#include <string>		// string
+#include <random>		// default_random_engine, mt19937_64, seed_seq
+#include <thread>		// this_thread
 #include <time.h>		// time
+#include <vector>
 
 // src
 #include "../types.hpp"
 #include "./lines.hpp"
 namespace T = kac_core::types;
 
-static std::default_random_engine random_engine(time(0l));
-static std::uniform_real_distribution<double> uniform_distribution(-1., 1.);
-static std::uniform_int_distribution<long>
-	uniform_sequence(std::numeric_limits<long>::min(), std::numeric_limits<long>::max());
+// the engine used by unseeded calls, of which each thread has its own
+static thread_local std::default_random_engine
+	random_engine(time(0l) + std::hash<std::thread::id>()(std::this_thread::get_id()));
 
 namespace kac_core::geometry {
 
-	inline T::Polygon generateConvexPolygon(const unsigned long& N, const time_t& seed = 0l) {
+	inline std::mt19937_64
+	indexedRandomEngine(const unsigned long& seed, const unsigned long& index) {
+		/*
+		Create a random engine keyed by both a seed and an index, such that the nth polygon of a
+		batch is identical regardless of which thread generates it, or in which order.
+		input:
+			seed = the seed shared by every polygon in the batch
+			index = the index of the polygon within the batch
+		output:
+			engine = a random engine unique to the pair (seed, index)
+		*/
+
+		std::seed_seq sequence({seed & 0xFFFFFFFF, seed >> 32, index & 0xFFFFFFFF, index >> 32});
+		return std::mt19937_64(sequence);
+	}
+
+	template <std::uniform_random_bit_generator Engine>
+	inline T::Polygon generateConvexPolygon(const unsigned long& N, Engine& engine) {
 		/*
 		Generate convex shapes according to Pavel Valtr's 1995 algorithm.
 		Adapted from Sander Verdonschot's Java version, found here:
 		https://cglab.ca/~sander/misc/ConvexGeneration/ValtrAlgorithm.java
 		input:
 			N = the number of vertices
-			seed? = the seed for the random number generators
+			engine = the random engine, which is advanced by this call
 		output:
 			P = a convex polygon of N random vertices
 		*/
 
 		// initialise variables
+		std::uniform_real_distribution<double> uniform_distribution(-1., 1.);
+		std::uniform_int_distribution<long> uniform_sequence(
+			std::numeric_limits<long>::min(), std::numeric_limits<long>::max()
+		);
 		T::Polygon P;
 		std::vector<double> X(N);
 		std::vector<double> Y(N);
@@ -45,21 +67,14 @@ namespace kac_core::geometry {
 		unsigned long last_true = 0;
 		unsigned long last_false = 0;
 		// initialise and sort random coordinates
-		if (seed != 0l) {
-			random_engine.seed(seed);
-		}
-		std::generate(X_rand.begin(), X_rand.end(), []() {
-			return uniform_distribution(random_engine);
-		});
-		std::generate(Y_rand.begin(), Y_rand.end(), []() {
-			return uniform_distribution(random_engine);
-		});
+		std::generate(X_rand.begin(), X_rand.end(), [&]() { return uniform_distribution(engine); });
+		std::generate(Y_rand.begin(), Y_rand.end(), [&]() { return uniform_distribution(engine); });
 		std::sort(X_rand.begin(), X_rand.end());
 		std::sort(Y_rand.begin(), Y_rand.end());
 		// divide the interior points into two chains
 		for (unsigned long n = 1; n < N; n++) {
 			if (n != N - 1) {
-				if (uniform_sequence(random_engine) % 2 == 1) {
+				if (uniform_sequence(engine) % 2 == 1) {
 					X[n] = X_rand[n] - X_rand[last_true];
 					Y[n] = Y_rand[n] - Y_rand[last_true];
 					last_true = n;
@@ -76,14 +91,17 @@ namespace kac_core::geometry {
 			}
 		}
 		// randomly combine x and y
-		shuffle(Y.begin(), Y.end(), random_engine);
+		shuffle(Y.begin(), Y.end(), engine);
 		for (unsigned long n = 0; n < N; n++) { P.push_back(T::Point(X[n], Y[n])); }
 		// sort by polar angle
 		sort(P.begin(), P.end(), [](T::Point& p1, T::Point& p2) {
 			return p1.theta() < p2.theta();
 		});
 		// arrange points end to end to form a polygon
-		double x_min, x_max, y_min, y_max = 0;
+		double x_min = 0.0;
+		double x_max = 0.0;
+		double y_min = 0.0;
+		double y_max = 0.0;
 		double x = 0.0;
 		double y = 0.0;
 		for (unsigned long n = 0; n < N; n++) {
@@ -106,30 +124,46 @@ namespace kac_core::geometry {
 		return P;
 	}
 
-	inline T::Polygon generateIrregularStar(const unsigned long& N, const time_t& seed = 0l) {
+	inline T::Polygon generateConvexPolygon(const unsigned long& N, const time_t& seed = 0l) {
+		/*
+		Generate a convex polygon, see generateConvexPolygon(N, engine). A seeded call creates its
+		own random engine, whereas an unseeded call advances the random engine of this thread.
+		input:
+			N = the number of vertices
+			seed? = the seed for the random number generators
+		output:
+			P = a convex polygon of N random vertices
+		*/
+
+		if (seed != 0l) {
+			std::default_random_engine engine(seed);
+			return generateConvexPolygon(N, engine);
+		}
+		return generateConvexPolygon(N, random_engine);
+	}
+
+	template <std::uniform_random_bit_generator Engine>
+	inline T::Polygon generateIrregularStar(const unsigned long& N, Engine& engine) {
 		/*
 		This is a fast method for generating concave polygons, particularly with a large number of
 		vertices. This approach generates polygons by ordering a series of random points around a
 		centre point. As a result, not all possible simple polygons are generated this way.
 		input:
 			N = the number of vertices
-			seed? = the seed for the random number generators
+			engine = the random engine, which is advanced by this call
 		output:
 			P = an irregular star of N random vertices
 		*/
 
 		// initialise variables
+		std::uniform_real_distribution<double> uniform_distribution(-1., 1.);
 		T::Matrix_1D X;
 		T::Matrix_1D Y;
 		T::Polygon P;
-		// initialise and sort random coordinates
-		if (seed != 0l) {
-			random_engine.seed(seed);
-		}
 		// first find minmax in both x & y
 		for (unsigned long n = 0; n < N; n++) {
-			X.push_back(uniform_distribution(random_engine));
-			Y.push_back(uniform_distribution(random_engine));
+			X.push_back(uniform_distribution(engine));
+			Y.push_back(uniform_distribution(engine));
 		}
 		auto x_min_max = std::minmax_element(begin(X), end(X));
 		auto y_min_max = std::minmax_element(begin(Y), end(Y));
@@ -144,36 +178,188 @@ namespace kac_core::geometry {
 		return P;
 	}
 
-	inline T::Polygon generatePolygon(const unsigned long& N, const time_t& seed = 0l) {
+	inline T::Polygon generateIrregularStar(const unsigned long& N, const time_t& seed = 0l) {
+		/*
+		Generate an irregular star, see generateIrregularStar(N, engine). A seeded call creates its
+		own random engine, whereas an unseeded call advances the random engine of this thread.
+		input:
+			N = the number of vertices
+			seed? = the seed for the random number generators
+		output:
+			P = an irregular star of N random vertices
+		*/
+
+		if (seed != 0l) {
+			std::default_random_engine engine(seed);
+			return generateIrregularStar(N, engine);
+		}
+		return generateIrregularStar(N, random_engine);
+	}
+
+	template <std::uniform_random_bit_generator Engine>
+	inline T::Polygon generatePolygon(const unsigned long& N, Engine& engine) {
 		/*
 		This algorithm is based on a method of eliminating self-intersections in a polygon by
 		using the Lin and Kerningham '2-opt' moves. Such a move eliminates an intersection between
 		two edges by reversing the order of the vertices between the edges. Intersecting edges are
-		detected using a simple sweep through the vertices and then one intersection is chosen at
-		random to eliminate after each sweep.
+		first detected using a sweep over the bounding boxes of each edge, after which the set of
+		intersections is updated after each move by testing only the two new edges. One
+		intersection is chosen at random to eliminate after each move, and as the intersections
+		are ranked in the order of an exhaustive search, the same polygon is generated for a given
+		seed as when every pair of edges is searched after each move.
 		https://doc.cgal.org/latest/Generator/group__PkgGeneratorsRef.html#gaa8cb58e4cc9ab9e225808799b1a61174
 		van Leeuwen, J., & Schoone, A. A. (1982). Untangling a traveling salesman tour in the plane.
 		input:
 			N = the number of vertices
-			seed? = the seed for the random number generators
+			engine = the random engine, which is advanced by this call
 		output:
 			P = a concave polygon of N random vertices
 		*/
 
 		// initialise variables
+		std::uniform_real_distribution<double> uniform_distribution(-1., 1.);
+		std::uniform_int_distribution<long> uniform_sequence(
+			std::numeric_limits<long>::min(), std::numeric_limits<long>::max()
+		);
 		T::Polygon P;
-		// initialise and sort random coordinates
-		if (seed != 0l) {
-			random_engine.seed(seed);
+		// initialise random coordinates
+		for (unsigned long n = 0; n < N; n++) {
+			P.push_back(T::Point(uniform_distribution(engine), uniform_distribution(engine)));
+		}
+		if (N < 4) {
+			return P;
+		}
+		// edge k runs from P[k] to P[k + 1], and the pairs (i, j) are those of an exhaustive
+		// search, i < N - 2 and i < j, which are ranked in lexicographic order
+		struct Crossing {
+			unsigned long i;
+			unsigned long j;
+			IntersectionType type;
+		};
+		std::vector<Crossing> crossings;
+		auto overlaps = [&P, &N](const unsigned long& i, const unsigned long& j) {
+			const T::Point& a = P[i];
+			const T::Point& b = P[(i + 1) % N];
+			const T::Point& c = P[j];
+			const T::Point& d = P[(j + 1) % N];
+			return std::max(a.x, b.x) >= std::min(c.x, d.x)
+				&& std::max(c.x, d.x) >= std::min(a.x, b.x)
+				&& std::max(a.y, b.y) >= std::min(c.y, d.y)
+				&& std::max(c.y, d.y) >= std::min(a.y, b.y);
+		};
+		auto record = [&P, &N, &crossings](unsigned long i, unsigned long j) {
+			if (i > j) {
+				std::swap(i, j);
+			}
+			if (i >= N - 2) {
+				return;
+			}
+			IntersectionType type =
+				classifyIntersection(T::Line(P[i], P[i + 1]), T::Line(P[j], P[(j + 1) % N])).first;
+			if (type != IntersectionType::None && type != IntersectionType::Vertex) {
+				crossings.push_back({i, j, type});
+			}
+		};
+		auto lexicographic = [](const Crossing& A, const Crossing& B) {
+			return A.i < B.i || (A.i == B.i && A.j < B.j);
+		};
+		// find the initial crossings using a sweep over the bounding boxes of each edge
+		std::vector<unsigned long> order(N);
+		for (unsigned long k = 0; k < N; k++) {
+			order[k] = k;
 		}
+		auto left = [&P, &N](const unsigned long& k) { return std::min(P[k].x, P[(k + 1) % N].x); };
+		std::sort(order.begin(), order.end(), [&left](unsigned long m, unsigned long n) {
+			return left(m) < left(n);
+		});
 		for (unsigned long n = 0; n < N; n++) {
-			P.push_back(
-				T::Point(uniform_distribution(random_engine), uniform_distribution(random_engine))
-			);
+			const double right = std::max(P[order[n]].x, P[(order[n] + 1) % N].x);
+			for (unsigned long m = n + 1; m < N && left(order[m]) <= right; m++) {
+				if (overlaps(order[n], order[m])) {
+					record(order[n], order[m]);
+				}
+			}
+		}
+		// 2 opt loop
+		while (crossings.size() > 0) {
+			// colinear edges are uncrossed first, otherwise one pair is swapped at random
+			unsigned long a = 0;
+			unsigned long b = 0;
+			auto colinear = crossings.end();
+			for (auto C = crossings.begin(); C != crossings.end(); C++) {
+				if (C->type == IntersectionType::Colinear
+					&& (colinear == crossings.end() || lexicographic(*C, *colinear))) {
+					colinear = C;
+				}
+			}
+			if (colinear != crossings.end()) {
+				const unsigned long i = colinear->i;
+				const unsigned long j = colinear->j;
+				a = i + (P[i].x < P[i + 1].x ? 0 : 1);
+				b = j + (P[j].x > P[(j + 1) % N].x ? 0 : 1);
+			} else {
+				auto swap = crossings.begin()
+						  + abs(uniform_sequence(engine)) % crossings.size();
+				std::nth_element(crossings.begin(), swap, crossings.end(), lexicographic);
+				a = swap->type == IntersectionType::Intersect ? swap->i + 1 : swap->i;
+				b = swap->type == IntersectionType::Intersect ? swap->j + 1 : swap->j;
+			}
+			std::reverse(P.begin() + a, P.begin() + b);
+			// the edges between a and b are renumbered, and only the two edges either side of the
+			// reversal are new, so only those are tested against every other edge
+			const unsigned long e_0 = (a + N - 1) % N;
+			const unsigned long e_1 = b - 1;
+			unsigned long count = 0;
+			for (Crossing C : crossings) {
+				if (C.i == e_0 || C.j == e_0 || C.i == e_1 || C.j == e_1) {
+					continue;
+				}
+				C.i = C.i >= a && C.i + 1 < b ? a + b - 2 - C.i : C.i;
+				C.j = C.j >= a && C.j + 1 < b ? a + b - 2 - C.j : C.j;
+				if (C.i > C.j) {
+					std::swap(C.i, C.j);
+				}
+				if (C.i < N - 2) {
+					crossings[count++] = C;
+				}
+			}
+			crossings.resize(count);
+			for (unsigned long k = 0; k < N; k++) {
+				if (k != e_0 && overlaps(e_0, k)) {
+					record(e_0, k);
+				}
+				if (e_1 != e_0 && k != e_1 && k != e_0 && overlaps(e_1, k)) {
+					record(e_1, k);
+				}
+			}
+		}
+		return P;
+	}
+
+	template <std::uniform_random_bit_generator Engine>
+	inline T::Polygon generatePolygonBruteForce(const unsigned long& N, Engine& engine) {
+		/*
+		Generate a simple polygon by searching every pair of edges for an intersection after each
+		2-opt move, which costs O(N^2) per move. For the same engine, this generates the same
+		polygon as generatePolygon(N, engine), and is retained as a reference.
+		*/
+
+		// initialise variables
+		std::uniform_real_distribution<double> uniform_distribution(-1., 1.);
+		std::uniform_int_distribution<long> uniform_sequence(
+			std::numeric_limits<long>::min(), std::numeric_limits<long>::max()
+		);
+		T::Polygon P;
+		// initialise random coordinates
+		for (unsigned long n = 0; n < N; n++) {
+			P.push_back(T::Point(uniform_distribution(engine), uniform_distribution(engine)));
+		}
+		if (N < 4) {
+			return P;
 		}
 		// 2 opt loop
 		std::vector<std::pair<long, long>> indices;
-		std::string intersection_type = "";
+		IntersectionType intersection_type = IntersectionType::None;
 		bool intersections = true;
 		while (intersections) {
 		Search_loop:
@@ -181,18 +367,19 @@ namespace kac_core::geometry {
 				for (unsigned long j = i + 1; j < N; j++) {
 					// collect indices of lines which should be crossed
 					intersection_type =
-						lineIntersection(T::Line(P[i], P[i + 1]), T::Line(P[j], P[(j + 1) % N]))
+						classifyIntersection(T::Line(P[i], P[i + 1]), T::Line(P[j], P[(j + 1) % N]))
 							.first;
-					if (intersection_type == "none" || intersection_type == "vertex") {
+					if (intersection_type == IntersectionType::None
+						|| intersection_type == IntersectionType::Vertex) {
 						continue;
-					} else if (intersection_type == "intersect") {
+					} else if (intersection_type == IntersectionType::Intersect) {
 						indices.push_back(std::make_pair(i + 1, j + 1));
-					} else if (intersection_type == "adjacent") {
+					} else if (intersection_type == IntersectionType::Adjacent) {
 						indices.push_back(std::make_pair(i, j));
-					} else if (intersection_type == "colinear") {
+					} else if (intersection_type == IntersectionType::Colinear) {
 						std::reverse(
 							P.begin() + i + (P[i].x < P[i + 1].x ? 0 : 1),
-							P.begin() + j + (P[j].x > P[j + 1].x ? 0 : 1)
+							P.begin() + j + (P[j].x > P[(j + 1) % N].x ? 0 : 1)
 						);
 						// restart loop
 						indices.clear();
@@ -203,7 +390,7 @@ namespace kac_core::geometry {
 			if (indices.size() > 0) {
 				// randomly swap one pair
 				std::pair<long, long> swap =
-					indices[abs(uniform_sequence(random_engine)) % indices.size()];
+					indices[abs(uniform_sequence(engine)) % indices.size()];
 				std::reverse(P.begin() + swap.first, P.begin() + swap.second);
 				// restart loop
 				indices.clear();
@@ -216,6 +403,24 @@ namespace kac_core::geometry {
 		return P;
 	}
 
+	inline T::Polygon generatePolygon(const unsigned long& N, const time_t& seed = 0l) {
+		/*
+		Generate a simple polygon, see generatePolygon(N, engine). A seeded call creates its own
+		random engine, whereas an unseeded call advances the random engine of this thread.
+		input:
+			N = the number of vertices
+			seed? = the seed for the random number generators
+		output:
+			P = a concave polygon of N random vertices
+		*/
+
+		if (seed != 0l) {
+			std::default_random_engine engine(seed);
+			return generatePolygon(N, engine);
+		}
+		return generatePolygon(N, random_engine);
+	}
+
 	inline T::Polygon generateUnitRectangle(const double& epsilon) {
 		/*
 		Define a rectangle with unit area and an aspect ration epsilon.
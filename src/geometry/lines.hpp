@@ -6,6 +6,7 @@ Utility functions for working with lines and curves.
 
 // core
 #include <algorithm>
+#include <array>
 #include <math.h>
 #include <stdexcept>
 #include <string>
@@ -17,12 +18,16 @@ namespace T = kac_core::types;
 
 namespace kac_core::geometry {
 
-	inline T::BooleanImage bresenham(T::BooleanImage& M, const T::Line& L) {
+	template <typename F>
+	inline void bresenhamLine(
+		const unsigned long& X, const unsigned long& Y, const T::Line& L, const F& paint
+	) {
 		/*
-		Apply the Bresenham line drawing algorithm to an input matrix.
+		Apply the Bresenham line drawing algorithm to an X * Y grid.
 		input:
-			M = input matrix.
+			X, Y = size of the grid.
 			L = line to draw, such that x ∈ [0, 1] && y ∈ [0, 1].
+			paint = a callback, paint(x, y), for each pixel of the line.
 		*/
 
 		// assert line is within the unit interval
@@ -33,10 +38,10 @@ namespace kac_core::geometry {
 			);
 		}
 		// handle discretisation
-		const unsigned long x_0 = lround(L.a.x * (M.size() - 1));
-		const unsigned long y_0 = lround(L.a.y * (M[0].size() - 1));
-		long dx = lround(L.b.x * (M.size() - 1)) - x_0;
-		long dy = lround(L.b.y * (M[0].size() - 1)) - y_0;
+		const unsigned long x_0 = lround(L.a.x * (X - 1));
+		const unsigned long y_0 = lround(L.a.y * (Y - 1));
+		long dx = lround(L.b.x * (X - 1)) - x_0;
+		long dy = lround(L.b.y * (Y - 1)) - y_0;
 		// configure directions
 		short xx, xy, yx, yy;
 		if (abs(dx) > abs(dy)) {
@@ -57,7 +62,7 @@ namespace kac_core::geometry {
 		unsigned long y = 0;
 		long D = 2 * dy - dx;
 		for (unsigned long x = 0; x < (dx + 1); x++) {
-			M[x_0 + x * xx + y * yx][y_0 + x * xy + y * yy] = 1;
+			paint(x_0 + x * xx + y * yx, y_0 + x * xy + y * yy);
 			// reposition y
 			if (D >= 0) {
 				y += 1;
@@ -65,6 +70,31 @@ namespace kac_core::geometry {
 			}
 			D += 2 * dy;
 		}
+	}
+
+	inline T::BooleanImage bresenham(T::BooleanImage& M, const T::Line& L) {
+		/*
+		Apply the Bresenham line drawing algorithm to an input matrix.
+		input:
+			M = input matrix.
+			L = line to draw, such that x ∈ [0, 1] && y ∈ [0, 1].
+		*/
+
+		bresenhamLine(M.size(), M[0].size(), L, [&M](unsigned long x, unsigned long y) {
+			M[x][y] = 1;
+		});
+		return M;
+	}
+
+	inline T::BitImage& bresenham(T::BitImage& M, const T::Line& L) {
+		/*
+		Apply the Bresenham line drawing algorithm to a packed input image.
+		input:
+			M = input image.
+			L = line to draw, such that x ∈ [0, 1] && y ∈ [0, 1].
+		*/
+
+		bresenhamLine(M.X, M.Y, L, [&M](unsigned long x, unsigned long y) { M.set(x, y); });
 		return M;
 	}
 
@@ -90,70 +120,101 @@ namespace kac_core::geometry {
 		return isColinear(A.a, A.b, p);
 	}
 
-	inline std::pair<std::string, T::Point> lineIntersection(const T::Line& A, const T::Line& B) {
+	enum class IntersectionType {
+		/*
+		The ways in which two line segments may intersect, see classifyIntersection().
+		*/
+
+		None,		 // No intersection.
+		Intersect,	 // The general case where lines intersect one another.
+		Vertex,		 // The special case when two lines share a vertex.
+		Adjacent,	 // The special case when a vertex lies on the other line.
+		Colinear,	 // The special case when the two lines overlap.
+	};
+
+	inline std::pair<IntersectionType, T::Point>
+	classifyIntersection(const T::Line& A, const T::Line& B) {
 		/*
 		This function determines whether a line has an intersection, and returns it's type as well
-		as the point of intersection (if one exists).
+		as the point of intersection (if one exists), without allocating.
 		input:
 			A, B - Line segments to compare.
 		output:
 			type -
-				'none'		No intersection.
-				'intersect' The general case where lines intersect one another.
-				'vertex'	This is the special case when two lines share a vertex.
-				'branch'	This is the special case when a vertex lies within another line. For
+				None		No intersection.
+				Intersect	The general case where lines intersect one another.
+				Vertex		This is the special case when two lines share a vertex.
+				Adjacent	This is the special case when a vertex lies on the other line. For
 							example, B creates an intersection at point B.a when B.a lies on the
 							open interval (A.a, A.b).
-				'colinear'	This is the special case when the two lines overlap.
+				Colinear	This is the special case when the two lines overlap.
 			point -
-				'none'		Empty point.
-				'intersect' The point of intersection ∈ (A.a, A.b) & (B.a, B.b).
-				'vertex'	The shared vertex.
-				'branch'	The branching vertex.
-				'colinear'	The midpoint between all 4 vertices.
+				None		Empty point.
+				Intersect	The point of intersection ∈ (A.a, A.b) & (B.a, B.b).
+				Vertex		The shared vertex.
+				Adjacent	The adjacent vertex.
+				Colinear	The midpoint between all 4 vertices.
 		*/
 
 		// search for shared vertices
 		if (A.a.x == B.a.x && A.a.y == B.a.y || A.a.x == B.b.x && A.a.y == B.b.y) {
-			return std::make_pair("vertex", A.a);
+			return std::make_pair(IntersectionType::Vertex, A.a);
 		} else if (A.b.x == B.a.x && A.b.y == B.a.y || A.b.x == B.b.x && A.b.y == B.b.y) {
-			return std::make_pair("vertex", A.b);
+			return std::make_pair(IntersectionType::Vertex, A.b);
 		}
 		// test for colinear cases.
 		if (isColinear(A.a, A.b, B.a) && isColinear(A.a, A.b, B.b)) {
 			if (isPointOnLine(A.a, B) || isPointOnLine(A.b, B) || isPointOnLine(B.a, A)
 				|| isPointOnLine(B.b, A)) {
 				return std::make_pair(
-					"colinear",
+					IntersectionType::Colinear,
 					T::Point(
 						(A.a.x + A.b.x + B.a.x + B.b.x) / 4, (A.a.y + A.b.y + B.a.y + B.b.y) / 4
 					)
 				);
 			}
-		} else {
-			// calculate the general case using distance to intersection point.
-			double u_A = ((B.b.x - B.a.x) * (A.a.y - B.a.y) - (B.b.y - B.a.y) * (A.a.x - B.a.x))
-					   / ((B.b.y - B.a.y) * (A.b.x - A.a.x) - (B.b.x - B.a.x) * (A.b.y - A.a.y));
-			double u_B = ((A.b.x - A.a.x) * (A.a.y - B.a.y) - (A.b.y - A.a.y) * (A.a.x - B.a.x))
-					   / ((B.b.y - B.a.y) * (A.b.x - A.a.x) - (B.b.x - B.a.x) * (A.b.y - A.a.y));
-			if (u_A >= 0 && u_A <= 1 && u_B >= 0 && u_B <= 1) {
-				T::Point p = T::Point(A.a.x + u_A * (A.b.x - A.a.x), A.a.y + u_A * (A.b.y - A.a.y));
-				// test for adjacent case
-				if (A.a.x == p.x && A.a.y == p.y) {
-					return std::make_pair("adjacent", A.a);
-				} else if (A.b.x == p.x && A.b.y == p.y) {
-					return std::make_pair("adjacent", A.b);
-				} else if (B.a.x == p.x && B.a.y == p.y) {
-					return std::make_pair("adjacent", B.a);
-				} else if (B.b.x == p.x && B.b.y == p.y) {
-					return std::make_pair("adjacent", B.b);
-				}
-				// return general case
-				return std::make_pair("intersect", p);
-			}
+			return std::make_pair(IntersectionType::None, T::Point());
+		}
+		// calculate the general case using distance to intersection point.
+		const double A_x = A.b.x - A.a.x;
+		const double A_y = A.b.y - A.a.y;
+		const double B_x = B.b.x - B.a.x;
+		const double B_y = B.b.y - B.a.y;
+		const double d_x = A.a.x - B.a.x;
+		const double d_y = A.a.y - B.a.y;
+		const double denominator = B_y * A_x - B_x * A_y;
+		const double u_A = (B_x * d_y - B_y * d_x) / denominator;
+		const double u_B = (A_x * d_y - A_y * d_x) / denominator;
+		if (!(u_A >= 0 && u_A <= 1 && u_B >= 0 && u_B <= 1)) {
+			return std::make_pair(IntersectionType::None, T::Point());
+		}
+		const T::Point p = T::Point(A.a.x + u_A * A_x, A.a.y + u_A * A_y);
+		// test for adjacent case
+		if (A.a.x == p.x && A.a.y == p.y) {
+			return std::make_pair(IntersectionType::Adjacent, A.a);
+		} else if (A.b.x == p.x && A.b.y == p.y) {
+			return std::make_pair(IntersectionType::Adjacent, A.b);
+		} else if (B.a.x == p.x && B.a.y == p.y) {
+			return std::make_pair(IntersectionType::Adjacent, B.a);
+		} else if (B.b.x == p.x && B.b.y == p.y) {
+			return std::make_pair(IntersectionType::Adjacent, B.b);
 		}
-		// return the null case
-		return std::make_pair("none", T::Point());
+		// return general case
+		return std::make_pair(IntersectionType::Intersect, p);
+	}
+
+	inline std::pair<std::string, T::Point> lineIntersection(const T::Line& A, const T::Line& B) {
+		/*
+		This function determines whether a line has an intersection, and returns it's type as
+		well as the point of intersection (if one exists). The type is one of 'none',
+		'intersect', 'vertex', 'adjacent' or 'colinear', see classifyIntersection().
+		*/
+
+		static const std::array<std::string, 5> names = {
+			"none", "intersect", "vertex", "adjacent", "colinear"
+		};
+		auto [type, p] = classifyIntersection(A, B);
+		return std::make_pair(names[static_cast<unsigned long>(type)], p);
 	}
 
 	inline T::Point lineMidpoint(const T::Line& L) {
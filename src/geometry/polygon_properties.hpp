@@ -6,9 +6,11 @@ Utility functions for working with polygons.
 
 // core
 #include <algorithm>
+#include <iterator>	// next, prev
 #include <math.h>
-#include <string>
+#include <set>
 #include <utility>
+#include <vector>
 
 // src
 #include "../types.hpp"
@@ -80,7 +82,7 @@ namespace kac_core::geometry {
 		const unsigned long N = P.size();
 		// create a ray that extends to the right of the polygon
 		double max_x = 0.;
-		for (unsigned long n = 0; n <= N; n++) { max_x = std::max(P[n].x, max_x); }
+		for (unsigned long n = 0; n < N; n++) { max_x = std::max(P[n].x, max_x); }
 		T::Line ray = T::Line(p, T::Point(max_x + 1., p.y));
 		// count the number of times the ray is intersected
 		unsigned long count = 0;
@@ -95,26 +97,157 @@ namespace kac_core::geometry {
 				return true;
 			}
 			// general case
-			if (lineIntersection(ray, A).first == "intersect") {
+			if (classifyIntersection(ray, A).first == IntersectionType::Intersect) {
 				count++;
 			}
 		}
 		return count % 2 == 1;
 	}
 
-	inline bool isSimple(const T::Polygon& P) {
+	inline bool isSimpleBruteForce(const T::Polygon& P) {
 		/*
-		Determine if a polygon is simple by checking for intersections.
+		Determine if a polygon is simple by checking every pair of edges for intersections. Edges
+		which only share a vertex are not considered to intersect. See isSimple().
 		*/
 
 		const unsigned long N = P.size();
 		for (unsigned long i = 0; i < N - 2; i++) {
 			for (unsigned long j = i + 1; j < N; j++) {
-				std::string intersection_type =
-					lineIntersection(T::Line(P[i], P[i + 1]), T::Line(P[j], P[(j + 1) % N])).first;
-				if (intersection_type != "none" && intersection_type != "vertex") {
+				const IntersectionType type =
+					classifyIntersection(T::Line(P[i], P[i + 1]), T::Line(P[j], P[(j + 1) % N]))
+						.first;
+				if (type != IntersectionType::None && type != IntersectionType::Vertex) {
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+
+	inline bool isSimple(const T::Polygon& P) {
+		/*
+		Determine if a polygon is simple using the Shamos-Hoey sweep line algorithm, which costs
+		O(N log N) rather than the O(N^2) of isSimpleBruteForce(). The edges are swept from left
+		to right, ordered from bottom to top in the sweep line, and only edges which become
+		neighbours in the sweep line are tested for an intersection. The sweep stops at the first
+		intersection, and as with isSimpleBruteForce(), edges which only share a vertex are not
+		considered to intersect. The two agree for every polygon, with the exception of
+		degenerate polygons in which an edge is retraced by another edge.
+		Shamos, M. I., & Hoey, D. (1976). Geometric intersection problems.
+		*/
+
+		const unsigned long N = P.size();
+		if (N < 4) {
+			return isSimpleBruteForce(P);
+		}
+		// the left and right endpoints of each edge, ordered by x and then y
+		auto before = [](const T::Point& a, const T::Point& b) {
+			return a.x < b.x || (a.x == b.x && a.y < b.y);
+		};
+		std::vector<std::pair<unsigned long, unsigned long>> ends(N);
+		for (unsigned long n = 0; n < N; n++) {
+			const unsigned long m = (n + 1) % N;
+			ends[n] = before(P[m], P[n]) ? std::make_pair(m, n) : std::make_pair(n, m);
+		}
+		// the order of two edges along the sweep line, which holds while no edges intersect
+		auto orientation = [](const T::Point& a, const T::Point& b, const T::Point& c) {
+			return (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+		};
+		auto below = [&P, &ends, &before, &orientation](
+						 const unsigned long& s, const unsigned long& t
+					 ) {
+			const bool s_first = !before(P[ends[t].first], P[ends[s].first]);
+			const std::pair<unsigned long, unsigned long>& e = s_first ? ends[s] : ends[t];
+			const std::pair<unsigned long, unsigned long>& f = s_first ? ends[t] : ends[s];
+			double o = orientation(P[e.first], P[e.second], P[f.first]);
+			if (o == 0.) {
+				o = orientation(P[e.first], P[e.second], P[f.second]);
+			}
+			if (o == 0.) {
+				return s < t;
+			}
+			return s_first ? o > 0. : o < 0.;
+		};
+		// test a pair of edges in the same order as isSimpleBruteForce()
+		auto classify = [&P, &N](unsigned long i, unsigned long j) {
+			if (i > j) {
+				std::swap(i, j);
+			}
+			return classifyIntersection(T::Line(P[i], P[i + 1]), T::Line(P[j], P[(j + 1) % N]))
+				.first;
+		};
+		// events are ordered by point, and then by removing edges before inserting them, except
+		// for edges of zero length, which are inserted and then removed
+		std::vector<std::pair<unsigned long, bool>> events;
+		events.reserve(2 * N);
+		for (unsigned long n = 0; n < N; n++) {
+			events.emplace_back(n, true);
+			events.emplace_back(n, false);
+		}
+		auto point = [&P, &ends](const std::pair<unsigned long, bool>& e) -> const T::Point& {
+			return P[e.second ? ends[e.first].first : ends[e.first].second];
+		};
+		auto rank = [&P, &ends](const std::pair<unsigned long, bool>& e) {
+			const T::Point& l = P[ends[e.first].first];
+			const T::Point& r = P[ends[e.first].second];
+			return e.second ? 1 : (l.x == r.x && l.y == r.y ? 2 : 0);
+		};
+		std::sort(
+			events.begin(),
+			events.end(),
+			[&point, &before, &rank](const auto& a, const auto& b) {
+				if (before(point(a), point(b))) {
+					return true;
+				} else if (before(point(b), point(a))) {
+					return false;
+				}
+				return rank(a) != rank(b) ? rank(a) < rank(b) : a.first < b.first;
+			}
+		);
+		// sweep
+		typedef std::set<unsigned long, decltype(below)> SweepLine;
+		SweepLine sweep(below);
+		std::vector<SweepLine::iterator> position(N);
+		// test the edge n against its neighbours in one direction. Edges which share a vertex
+		// with n may overlap it without being considered to intersect, and so may hide an
+		// intersection with the next neighbour, which is then also tested.
+		auto intersectsBelow = [&sweep, &classify](SweepLine::iterator it, unsigned long n) {
+			while (it != sweep.begin()) {
+				const IntersectionType type = classify(*--it, n);
+				if (type != IntersectionType::None && type != IntersectionType::Vertex) {
+					return true;
+				} else if (type == IntersectionType::None) {
+					return false;
+				}
+			}
+			return false;
+		};
+		auto intersectsAbove = [&sweep, &classify](SweepLine::iterator it, unsigned long n) {
+			for (++it; it != sweep.end(); ++it) {
+				const IntersectionType type = classify(*it, n);
+				if (type != IntersectionType::None && type != IntersectionType::Vertex) {
+					return true;
+				} else if (type == IntersectionType::None) {
+					return false;
+				}
+			}
+			return false;
+		};
+		for (const auto& [n, insert]: events) {
+			if (insert) {
+				position[n] = sweep.insert(n).first;
+				if (intersectsBelow(position[n], n) || intersectsAbove(position[n], n)) {
+					return false;
+				}
+			} else {
+				// the neighbours of n become neighbours of one another
+				auto it = position[n];
+				if (it != sweep.begin() && std::next(it) != sweep.end()
+					&& (intersectsAbove(it, *std::prev(it))
+						|| intersectsBelow(it, *std::next(it)))) {
 					return false;
 				}
+				sweep.erase(it);
 			}
 		}
 		return true;
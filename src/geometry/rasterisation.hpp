@@ -0,0 +1,186 @@
+/*
+Functions for rasterising polygons, such as the boundary conditions of an FDTD simulation.
+*/
+
+#pragma once
+
+// core
+#include <algorithm>	// max, min, sort
+#include <math.h>
+#include <stdexcept>
+#include <vector>
+
+// src
+#include "../types.hpp"
+namespace T = kac_core::types;
+
+namespace kac_core::geometry {
+
+	enum class RasterMode {
+		/*
+		How pixels on the boundary of a polygon are rasterised.
+		*/
+
+		Centre,			// a pixel is set if its centre lies inside of the polygon
+		Conservative,	// a pixel is set if any part of it touches the polygon
+	};
+
+	inline void scanlineIntervals(const T::Polygon& P, const double& x, T::Matrix_1D& I) {
+		/*
+		Find the intervals along the scanline at x that lie inside of a polygon, according to the
+		even-odd rule. An edge crosses the scanline if exactly one of its vertices satisfies
+		v.x <= x, such that every vertex on the scanline is counted once.
+		input:
+			P = polygon.
+			x = the position of the scanline.
+		output:
+			I = the sorted crossings, such that [I[2i], I[2i + 1]) lies inside of P.
+		*/
+
+		const unsigned long N = P.size();
+		I.clear();
+		for (unsigned long n = 0; n < N; n++) {
+			const T::Point& a = P[n];
+			const T::Point& b = P[(n + 1) % N];
+			if ((a.x <= x) != (b.x <= x)) {
+				I.push_back(a.y + (x - a.x) * (b.y - a.y) / (b.x - a.x));
+			}
+		}
+		std::sort(I.begin(), I.end());
+	}
+
+	inline void rasterisePolygon(
+		const T::Polygon& P, T::BitImage& M, const RasterMode& mode = RasterMode::Centre
+	) {
+		/*
+		Rasterise a polygon into a packed image using an even-odd scanline fill. As with
+		bresenham(), the image spans the unit square, such that the centre of the pixel (x, y)
+		lies at (x / (X - 1), y / (Y - 1)), see normalisePolygon(). Each row is filled from the
+		sorted crossings of its scanline, a word at a time, which costs O(XN + XY / 64) rather
+		than the O(XYN) of testing every pixel with isPointInsidePolygon().
+
+		In the conservative mode, a pixel is also set when the polygon touches any part of it.
+		The polygon's extent along the strip of a row is the union of its scanlines at either
+		side of the strip, and the edges that it clips.
+		input:
+			P = polygon, such that x ∈ [0, 1] && y ∈ [0, 1].
+			M = the output image, of size X * Y.
+			mode = the treatment of the boundary.
+		*/
+
+		// handle errors
+		if (M.X < 2 || M.Y < 2) {
+			throw std::invalid_argument("M must have at least 2 pixels along each axis.");
+		}
+		const double X_1 = M.X - 1.;
+		const double Y_1 = M.Y - 1.;
+		const unsigned long N = P.size();
+		std::fill(M.data.begin(), M.data.end(), 0);
+		// set every pixel with a centre within [y_a, y_b), or touching [y_a, y_b] if conservative
+		const bool centre = mode == RasterMode::Centre;
+		auto fill = [&M, &centre, &Y_1](const unsigned long& x, double y_a, double y_b) {
+			const double u_a = centre ? ceil(y_a * Y_1) : ceil(y_a * Y_1 - 0.5);
+			const double u_b = centre ? ceil(y_b * Y_1) : floor(y_b * Y_1 + 0.5) + 1.;
+			const double y_0 = std::max(u_a, 0.);
+			const double y_1 = std::min(u_b, static_cast<double>(M.Y));
+			if (y_0 < y_1) {
+				M.setSpan(x, static_cast<unsigned long>(y_0), static_cast<unsigned long>(y_1));
+			}
+		};
+		T::Matrix_1D I;
+		for (unsigned long x = 0; x < M.X; x++) {
+			if (centre) {
+				scanlineIntervals(P, x / X_1, I);
+				for (unsigned long i = 0; i + 1 < I.size(); i += 2) { fill(x, I[i], I[i + 1]); }
+				continue;
+			}
+			// scanlines at either side of the strip
+			const double x_a = (x - 0.5) / X_1;
+			const double x_b = (x + 0.5) / X_1;
+			for (const double& x_s: {x_a, x_b}) {
+				scanlineIntervals(P, x_s, I);
+				for (unsigned long i = 0; i + 1 < I.size(); i += 2) { fill(x, I[i], I[i + 1]); }
+			}
+			// edges clipped to the strip
+			for (unsigned long n = 0; n < N; n++) {
+				const T::Point& a = P[n];
+				const T::Point& b = P[(n + 1) % N];
+				if (std::max(a.x, b.x) < x_a || std::min(a.x, b.x) > x_b) {
+					continue;
+				}
+				double y_a = a.y;
+				double y_b = b.y;
+				if (a.x != b.x) {
+					const double t_a = std::clamp((x_a - a.x) / (b.x - a.x), 0., 1.);
+					const double t_b = std::clamp((x_b - a.x) / (b.x - a.x), 0., 1.);
+					y_a = a.y + t_a * (b.y - a.y);
+					y_b = a.y + t_b * (b.y - a.y);
+				}
+				fill(x, std::min(y_a, y_b), std::max(y_a, y_b));
+			}
+		}
+	}
+
+	inline T::BitImage rasterisePolygon(
+		const T::Polygon& P,
+		const unsigned long& X,
+		const unsigned long& Y,
+		const RasterMode& mode = RasterMode::Centre
+	) {
+		/*
+		Rasterise a polygon into a new packed image of size X * Y. See above.
+		*/
+
+		T::BitImage M(X, Y);
+		rasterisePolygon(P, M, mode);
+		return M;
+	}
+
+	inline T::Matrix_2D polygonCoverage(
+		const T::Polygon& P,
+		const unsigned long& X,
+		const unsigned long& Y,
+		const unsigned long& samples = 4
+	) {
+		/*
+		Calculate the anti-aliased coverage of each pixel by a polygon. Each pixel spans
+		[(x - 0.5) / (X - 1), (x + 0.5) / (X - 1)] along the X axis, see rasterisePolygon(), and
+		is sampled by a number of evenly spaced scanlines, along which the coverage is exact.
+		input:
+			P = polygon, such that x ∈ [0, 1] && y ∈ [0, 1].
+			X, Y = size of the image.
+			samples = the number of scanlines per pixel.
+		output:
+			C = { c ∈ [0, 1] | the fraction of each pixel inside of P }
+		*/
+
+		// handle errors
+		if (X < 2 || Y < 2) {
+			throw std::invalid_argument("The image must have at least 2 pixels along each axis.");
+		}
+		if (samples == 0) {
+			throw std::invalid_argument("samples must be greater than 0.");
+		}
+		const double X_1 = X - 1.;
+		const double Y_1 = Y - 1.;
+		const double weight = 1. / samples;
+		T::Matrix_2D C(X, T::Matrix_1D(Y, 0.));
+		T::Matrix_1D I;
+		for (unsigned long x = 0; x < X; x++) {
+			for (unsigned long s = 0; s < samples; s++) {
+				scanlineIntervals(P, (x - 0.5 + (s + 0.5) * weight) / X_1, I);
+				for (unsigned long i = 0; i + 1 < I.size(); i += 2) {
+					// the pixel y spans [y, y + 1) in units of u
+					const double u_a = std::max(I[i] * Y_1 + 0.5, 0.);
+					const double u_b = std::min(I[i + 1] * Y_1 + 0.5, static_cast<double>(Y));
+					for (double y = floor(u_a); y < u_b; y++) {
+						const double overlap = std::min(u_b, y + 1.) - std::max(u_a, y);
+						C[x][static_cast<unsigned long>(y)] += overlap * weight;
+					}
+				}
+			}
+		}
+		return C;
+	}
+
+}
@@ -5,3 +5,4 @@
 #include "physics/fdtd/__index__.hpp"
 #include "physics/modes/__index__.hpp"
 #include "types.hpp"
+#include "utils/__index__.hpp"
@@ -4,5 +4,8 @@ Central import for all files in /fdtd.
 
 #pragma once
 
+#include "batch.hpp"
 #include "fdtd.hpp"
 #include "initial_conditions.hpp"
+#include "simulator.hpp"
+#include "stencil.hpp"
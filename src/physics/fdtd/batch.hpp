@@ -0,0 +1,161 @@
+/*
+Batched FDTD simulations, for generating datasets of many independent drums.
+*/
+
+#pragma once
+
+// core
+#include <array>
+#include <chrono>
+#include <stdexcept>
+#include <type_traits>	// type_identity_t
+#include <utility>		// move
+#include <vector>
+
+// src
+#include "../../types.hpp"
+#include "../../utils/thread_pool.hpp"
+#include "./fdtd.hpp"
+namespace T = kac_core::types;
+namespace U = kac_core::utils;
+
+namespace kac_core::physics {
+
+	template <typename Scalar = double>
+	struct FDTDJob {
+		/*
+		The parameters of a single FDTD simulation.
+		*/
+
+		// vars
+		T::Grid<Scalar> u_0;		// initial fdtd grid at t = 0
+		T::Grid<Scalar> u_1;		// initial fdtd grid at t = 1
+		T::Grid<short> B;			// boundary conditions
+		Scalar c_0 = 0.;			// first fdtd coefficient
+		Scalar c_1 = 0.;			// second fdtd coefficient
+		Scalar c_2 = 0.;			// third fdtd coefficient
+		unsigned long length = 0;	// length of simulation in samples
+		std::vector<T::Point> W;	// coordinates at which the waveforms are sampled
+
+		// constructors
+		FDTDJob() {};
+		FDTDJob(
+			T::Grid<Scalar> u_0,
+			T::Grid<Scalar> u_1,
+			T::Grid<short> B,
+			const std::type_identity_t<Scalar>& c_0,
+			const std::type_identity_t<Scalar>& c_1,
+			const std::type_identity_t<Scalar>& c_2,
+			const unsigned long& length,
+			std::vector<T::Point> W
+		):
+			u_0(std::move(u_0)),
+			u_1(std::move(u_1)),
+			B(std::move(B)),
+			c_0(c_0),
+			c_1(c_1),
+			c_2(c_2),
+			length(length),
+			W(std::move(W)) {};
+	};
+
+	template <typename Scalar = double>
+	struct FDTDBatchResult {
+		/*
+		The output of a batch of FDTD simulations.
+		*/
+
+		// vars
+		std::vector<std::vector<std::vector<Scalar>>> waveforms;	// waveforms[job][read point]
+		double seconds = 0.;										// wall time of the batch
+		double simulations_per_second = 0.;							// aggregate throughput
+	};
+
+	template <typename Scalar = double>
+	class FDTDBatch {
+		/*
+		Run batches of independent FDTD simulations across a thread pool. Simulations are
+		scheduled using work stealing, such that drums of differing sizes and lengths are
+		balanced across the pool. Each thread of the pool owns a pair of grid buffers, which are
+		reused by every simulation that the thread runs, and by every subsequent batch.
+		*/
+
+	public:
+		// constructors
+		FDTDBatch(U::ThreadPool& pool = U::defaultThreadPool()):
+			pool(pool), buffers(pool.size()) {};
+
+		// methods
+		FDTDBatchResult<Scalar> operator()(const std::vector<FDTDJob<Scalar>>& jobs) {
+			/*
+			Run a batch of simulations.
+			input:
+				jobs = the parameters of each simulation.
+			output:
+				result = the waveforms of each simulation, equal to those of FDTDWaveform2D(),
+					and the throughput of the batch.
+			*/
+
+			// handle errors
+			for (const FDTDJob<Scalar>& job: jobs) {
+				if (job.u_0.X != job.u_1.X || job.u_0.Y != job.u_1.Y) {
+					throw std::invalid_argument("u_0 and u_1 differ in size.");
+				}
+				if (job.u_0.X != job.B.X || job.u_0.Y != job.B.Y) {
+					throw std::invalid_argument("u_0 and B differ in size.");
+				}
+			}
+			// initialise output
+			FDTDBatchResult<Scalar> result;
+			result.waveforms.resize(jobs.size());
+			for (unsigned long i = 0; i < jobs.size(); i++) {
+				result.waveforms[i].assign(jobs[i].W.size(), std::vector<Scalar>(jobs[i].length));
+			}
+			// run the batch
+			const auto start = std::chrono::steady_clock::now();
+			pool.schedule(
+				jobs.size(),
+				[this, &jobs, &result](const unsigned long& i, const unsigned long& n) {
+					simulate(jobs[i], buffers[n], result.waveforms[i]);
+				}
+			);
+			result.seconds =
+				std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+			result.simulations_per_second = result.seconds > 0. ? jobs.size() / result.seconds : 0.;
+			return result;
+		}
+
+	private:
+		// vars
+		U::ThreadPool& pool;
+		std::vector<std::array<T::Grid<Scalar>, 2>> buffers;
+
+		// methods
+		static void simulate(
+			const FDTDJob<Scalar>& job,
+			std::array<T::Grid<Scalar>, 2>& u,
+			std::vector<std::vector<Scalar>>& waveforms
+		) {
+			/*
+			Run a single simulation using a pair of pooled buffers. Copy assignment reuses the
+			storage of each buffer whenever it is large enough.
+			*/
+
+			u[0] = job.u_0;
+			u[1] = job.u_1;
+			std::vector<FDTDReadPoint> read;
+			read.reserve(job.W.size());
+			for (const T::Point& w: job.W) { read.emplace_back(w, job.B.X, job.B.Y); }
+			const std::vector<T::Span> S = FDTDActiveSpans(job.B);
+			for (unsigned long t = 0; t < job.length; t++) {
+				if (t > 1) {
+					FDTDUpdate2D(u[t % 2], u[(t + 1) % 2], S, job.c_0, job.c_1, job.c_2);
+				}
+				for (unsigned long i = 0; i < read.size(); i++) {
+					waveforms[i][t] = read[i](u[t % 2]);
+				}
+			}
+		}
+	};
+
+}
@@ -1,5 +1,6 @@
 /*
-Functions for producing a raised cosine transform for different dimensionalities.
+Functions for producing a raised cosine transform for different dimensionalities. Each function is
+templated on the scalar type of its output, and is evaluated in double precision.
 */
 
 #pragma once
@@ -16,7 +17,8 @@ using namespace kac_core::types;
 
 namespace kac_core::physics {
 
-	inline Matrix_1D
+	template <typename Scalar = double>
+	inline std::vector<Scalar>
 	raisedCosine1D(const unsigned long& size, const double& mu, const double& sigma) {
 		/*
 		Calculate a one dimensional raised cosine distribution.
@@ -32,7 +34,7 @@ namespace kac_core::physics {
 			}
 		*/
 
-		Matrix_1D raised_cosine(size);
+		std::vector<Scalar> raised_cosine(size);
 		for (unsigned long x = 0; x < size; x++) {
 			double x_diff = fabs(x - mu);
 			if (x_diff <= sigma) {
@@ -42,7 +44,8 @@ namespace kac_core::physics {
 		return raised_cosine;
 	}
 
-	inline Matrix_2D raisedCosine2D(
+	template <typename Scalar = double>
+	inline std::vector<std::vector<Scalar>> raisedCosine2D(
 		const unsigned long& size_X,
 		const unsigned long& size_Y,
 		const T::Point& mu,
@@ -63,7 +66,7 @@ namespace kac_core::physics {
 			}
 		*/
 
-		Matrix_2D raised_cosine(size_X, Matrix_1D(size_Y, 0));
+		std::vector<std::vector<Scalar>> raised_cosine(size_X, std::vector<Scalar>(size_Y, 0));
 		for (unsigned long x = 0; x < size_X; x++) {
 			for (unsigned long y = 0; y < size_Y; y++) {
 				double l2_norm = sqrt(pow((x - mu.x), 2) + pow((y - mu.y), 2));
@@ -75,7 +78,8 @@ namespace kac_core::physics {
 		return raised_cosine;
 	}
 
-	inline Matrix_1D raisedTriangle1D(
+	template <typename Scalar = double>
+	inline std::vector<Scalar> raisedTriangle1D(
 		const unsigned long& size, const double& mu, const double& a, const double& b
 	) {
 		/*
@@ -95,7 +99,7 @@ namespace kac_core::physics {
 			}
 		*/
 
-		Matrix_1D triangle(size);
+		std::vector<Scalar> triangle(size);
 		for (unsigned long x = 0; x < size; x++) {
 			triangle[x] = a <= x && x <= mu ? double(x - a) / double(mu - a)
 						: mu < x && x <= b	? 1. - double(x - mu) / double(b - mu)
@@ -104,7 +108,8 @@ namespace kac_core::physics {
 		return triangle;
 	}
 
-	inline Matrix_2D raisedTriangle2D(
+	template <typename Scalar = double>
+	inline std::vector<std::vector<Scalar>> raisedTriangle2D(
 		const unsigned long& size_X,
 		const unsigned long& size_Y,
 		const T::Point& mu,
@@ -126,7 +131,7 @@ namespace kac_core::physics {
 		*/
 
 		Matrix_1D y_t = raisedTriangle1D(size_Y, mu.y, y_a, y_b);
-		Matrix_2D triangle(size_X, Matrix_1D(size_Y, 0));
+		std::vector<std::vector<Scalar>> triangle(size_X, std::vector<Scalar>(size_Y, 0));
 		for (unsigned long x = 0; x < size_X; x++) {
 			double x_t = x_a <= x && x <= mu.x ? double(x - x_a) / double(mu.x - x_a)
 					   : mu.x < x && x <= x_b  ? 1. - double(x - mu.x) / double(x_b - mu.x)
@@ -0,0 +1,234 @@
+/*
+A stateful FDTD simulation, which renders its waveform incrementally in blocks.
+*/
+
+#pragma once
+
+// core
+#include <algorithm>	// copy
+#include <stdexcept>
+#include <type_traits>	// type_identity_t
+#include <utility>		// move
+#include <vector>
+
+// src
+#include "../../types.hpp"
+#include "./fdtd.hpp"
+#include "./stencil.hpp"
+namespace T = kac_core::types;
+
+namespace kac_core::physics {
+
+	template <typename Scalar = double>
+	class FDTDSimulator {
+		/*
+		A 2 dimensional FDTD simulation, which owns its grids, the active spans of its boundary
+		conditions and its coefficients, such that the waveform can be streamed in blocks of
+		arbitrary size. The simulation may be sampled at multiple read points, each of which
+		produces one channel of the output. The streamed waveforms are identical to those of
+		FDTDWaveform2D(), and process() performs no allocation.
+		*/
+
+	public:
+		// constructors
+		FDTDSimulator(
+			T::Grid<Scalar> u_0,
+			T::Grid<Scalar> u_1,
+			const T::Grid<short>& B,
+			const std::type_identity_t<Scalar>& c_0,
+			const std::type_identity_t<Scalar>& c_1,
+			const std::type_identity_t<Scalar>& c_2,
+			const T::Point& w
+		):
+			FDTDSimulator(
+				std::move(u_0),
+				std::move(u_1),
+				B,
+				c_0,
+				c_1,
+				c_2,
+				std::vector<T::Point>({w})
+			) {};
+		FDTDSimulator(
+			T::Grid<Scalar> u_0,
+			T::Grid<Scalar> u_1,
+			const T::Grid<short>& B,
+			const std::type_identity_t<Scalar>& c_0,
+			const std::type_identity_t<Scalar>& c_1,
+			const std::type_identity_t<Scalar>& c_2,
+			const std::vector<T::Point>& W
+		):
+			FDTDSimulator(
+				std::move(u_0), std::move(u_1), std::vector<T::Span>(), c_0, c_1, c_2, W
+			) {
+			// handle errors, before B is compiled into spans
+			if (this->u_0.X != B.X || this->u_0.Y != B.Y) {
+				throw std::invalid_argument("u_0 and B differ in size.");
+			}
+			S = FDTDActiveSpans(B);
+		};
+		FDTDSimulator(
+			T::Grid<Scalar> u_0,
+			T::Grid<Scalar> u_1,
+			const T::BitImage& B,
+			const std::type_identity_t<Scalar>& c_0,
+			const std::type_identity_t<Scalar>& c_1,
+			const std::type_identity_t<Scalar>& c_2,
+			const std::vector<T::Point>& W
+		):
+			FDTDSimulator(
+				std::move(u_0), std::move(u_1), std::vector<T::Span>(), c_0, c_1, c_2, W
+			) {
+			// handle errors, before B is compiled into spans
+			if (this->u_0.X != B.X || this->u_0.Y != B.Y) {
+				throw std::invalid_argument("u_0 and B differ in size.");
+			}
+			S = FDTDActiveSpans(B);
+		};
+		FDTDSimulator(
+			T::Grid<Scalar> u_0,
+			T::Grid<Scalar> u_1,
+			std::vector<T::Span> S,
+			const std::type_identity_t<Scalar>& c_0,
+			const std::type_identity_t<Scalar>& c_1,
+			const std::type_identity_t<Scalar>& c_2,
+			const std::vector<T::Point>& W
+		):
+			u_0(std::move(u_0)),
+			u_1(std::move(u_1)),
+			S(std::move(S)),
+			c_0(c_0),
+			c_1(c_1),
+			c_2(c_2),
+			stencil(FDTDStencil<Scalar>(U::detectSIMDLevel(), false)) {
+			/*
+			input:
+				u_0 = initial fdtd grid at t = 0.
+				u_1 = initial fdtd grid at t = 1.
+				B = boundary conditions, either unpacked, packed, or as active spans, see
+					FDTDActiveSpans().
+				c_0 = first fdtd coefficient related to the decay term and the courant number.
+				c_1 = second fdtd coefficient related to the decay term and the courant number.
+				c_2 = third fdtd coefficient related to the decay term.
+				W = the coordinates at which the waveforms are sampled ∈ ℝ^2, [0. 1.].
+			*/
+
+			// handle errors
+			if (this->u_0.X != this->u_1.X || this->u_0.Y != this->u_1.Y) {
+				throw std::invalid_argument("u_0 and u_1 differ in size.");
+			}
+			for (const T::Span& s: this->S) {
+				if (s.x == 0 || s.x + 1 >= this->u_0.X || s.y_0 == 0 || s.y_1 + 1 > this->u_0.Y) {
+					throw std::invalid_argument("S contains a span on the edge of the grid.");
+				}
+			}
+			// sample the 2D grid using bilinear interpolation at every read point.
+			read.reserve(W.size());
+			for (const T::Point& w: W) { read.emplace_back(w, this->u_0.X, this->u_0.Y); }
+		}
+
+		// methods
+		void process(float* out, const size_t& n) {
+			/*
+			Render the next n frames of the waveforms, with the channels of each frame interleaved.
+			input:
+				out = a buffer of at least n * channels() samples.
+				n = the number of frames to render.
+			*/
+
+			for (size_t i = 0; i < n; i++, t++, out += read.size()) {
+				if (t == 0) {
+					sample(u_0, out);
+				} else if (t == 1) {
+					sample(u_1, out);
+				} else if ((t % 2) == 0) {
+					update(u_0, u_1);
+					sample(u_0, out);
+				} else {
+					update(u_1, u_0);
+					sample(u_1, out);
+				}
+			}
+		}
+
+		void reset(const T::Grid<Scalar>& u_0, const T::Grid<Scalar>& u_1) {
+			/*
+			Restart the simulation from new initial conditions, reusing the existing grids.
+			input:
+				u_0 = initial fdtd grid at t = 0.
+				u_1 = initial fdtd grid at t = 1.
+			*/
+
+			// handle errors
+			const unsigned long X = this->u_0.X;
+			const unsigned long Y = this->u_0.Y;
+			if (u_0.X != X || u_0.Y != Y || u_1.X != X || u_1.Y != Y) {
+				throw std::invalid_argument("u_0 and u_1 must be the same size as B.");
+			}
+			for (unsigned long x = 0; x < X; x++) {
+				std::copy(u_0.row(x), u_0.row(x) + Y, this->u_0.row(x));
+				std::copy(u_1.row(x), u_1.row(x) + Y, this->u_1.row(x));
+			}
+			t = 0;
+		}
+
+		unsigned long channels() const {
+			/*
+			The number of channels in each frame, equal to the number of read points.
+			*/
+
+			return read.size();
+		}
+
+		unsigned long time() const {
+			/*
+			The number of frames rendered since the start of the simulation.
+			*/
+
+			return t;
+		}
+
+	private:
+		// vars
+		T::Grid<Scalar> u_0;
+		T::Grid<Scalar> u_1;
+		std::vector<T::Span> S;
+		Scalar c_0;
+		Scalar c_1;
+		Scalar c_2;
+		std::vector<FDTDReadPoint> read;
+		FDTDStencilKernel<Scalar> stencil;
+		unsigned long t = 0;
+
+		// methods
+		void sample(const T::Grid<Scalar>& u, float* frame) const {
+			/*
+			Sample every read point of the grid u into a single frame.
+			*/
+
+			for (unsigned long i = 0; i < read.size(); i++) { frame[i] = read[i](u); }
+		}
+
+		void update(T::Grid<Scalar>& u_a, const T::Grid<Scalar>& u_b) const {
+			/*
+			Advance the simulation by one step, in place on u_a.
+			*/
+
+			for (const T::Span& s: S) {
+				stencil(
+					u_a.row(s.x),
+					u_b.row(s.x),
+					u_b.row(s.x - 1),
+					u_b.row(s.x + 1),
+					nullptr,
+					s.y_0,
+					s.y_1,
+					c_0,
+					c_1,
+					c_2
+				);
+			}
+		}
+	};
+
+}
@@ -0,0 +1,308 @@
+/*
+Vectorised kernels for the five-point FDTD stencil. Each kernel updates a single row of the grid,
+and uses the boundary conditions as a mask rather than branching per cell. Unmasked kernels are
+also provided for runs of cells which are known to lie inside of the boundary conditions. The
+scalar, AVX2 and AVX-512 kernels perform the same operations in the same order, and so produce
+identical results. Kernels are provided for both single and double precision.
+*/
+
+#pragma once
+
+// core
+#include <algorithm>	// min
+#include <type_traits>	// is_floating_point_v, is_same_v
+
+// src
+#include "../../utils/simd.hpp"
+namespace U = kac_core::utils;
+
+namespace kac_core::physics {
+
+	// A kernel for updating the row u_a[y_0:y_1] in place.
+	template <typename Scalar>
+	using FDTDStencilKernel = void (*)(
+		Scalar* u_a,
+		const Scalar* u_b,
+		const Scalar* u_b_prev,
+		const Scalar* u_b_next,
+		const short* B,
+		unsigned long y_0,
+		unsigned long y_1,
+		Scalar c_0,
+		Scalar c_1,
+		Scalar c_2
+	);
+
+	template <typename Scalar, bool Masked = true>
+	KAC_CORE_NO_CONTRACT inline void FDTDStencilScalar(
+		Scalar* u_a,
+		const Scalar* u_b,
+		const Scalar* u_b_prev,
+		const Scalar* u_b_next,
+		const short* B,
+		unsigned long y_0,
+		unsigned long y_1,
+		Scalar c_0,
+		Scalar c_1,
+		Scalar c_2
+	) {
+		/*
+		Portable five-point stencil for a single row of the FDTD grid.
+		input:
+			u_a = row x of the fdtd grid at t = -1, updated in place.
+			u_b = row x of the fdtd grid at t = 0.
+			u_b_prev = row x - 1 of the fdtd grid at t = 0.
+			u_b_next = row x + 1 of the fdtd grid at t = 0.
+			B = row x of the boundary conditions, ignored when Masked is false.
+			y_0, y_1 = the half open range [y_0, y_1) of the update.
+			c_0, c_1, c_2 = fdtd coefficients.
+		output:
+			u_a[y] = {
+				c_0 * (u_b[y + 1] + u_b_next[y] + u_b[y - 1] + u_b_prev[y])
+					+ c_1 * u_b[y] - c_2 * u_a[y],	B[y] != 0 || !Masked
+				u_a[y],								B[y] == 0 && Masked
+			}
+		*/
+
+		static_assert(std::is_floating_point_v<Scalar>, "Scalar must be a floating point type.");
+		KAC_CORE_FP_CONTRACT_OFF
+		for (unsigned long y = y_0; y < y_1; y++) {
+			Scalar u = (u_b[y + 1] + u_b_next[y] + u_b[y - 1] + u_b_prev[y]) * c_0 + c_1 * u_b[y]
+					 - c_2 * u_a[y];
+			if constexpr (Masked) {
+				u_a[y] = B[y] != 0 ? u : u_a[y];
+			} else {
+				u_a[y] = u;
+			}
+		}
+	}
+
+#ifdef KAC_CORE_X86_SIMD
+	template <bool Masked = true>
+	KAC_CORE_NO_CONTRACT __attribute__((target("avx2"))) inline void FDTDStencilAVX2(
+		double* u_a,
+		const double* u_b,
+		const double* u_b_prev,
+		const double* u_b_next,
+		const short* B,
+		unsigned long y_0,
+		unsigned long y_1,
+		double c_0,
+		double c_1,
+		double c_2
+	) {
+		/*
+		AVX2 five-point stencil, updating 4 cells per iteration. When masked, cells outside of the
+		boundary conditions are restored using a blend.
+		*/
+
+		const __m256d c_0_v = _mm256_set1_pd(c_0);
+		const __m256d c_1_v = _mm256_set1_pd(c_1);
+		const __m256d c_2_v = _mm256_set1_pd(c_2);
+		const __m256i zero = _mm256_setzero_si256();
+		unsigned long y = y_0;
+		for (; y + 4 <= y_1; y += 4) {
+			__m256d a = _mm256_loadu_pd(u_a + y);
+			__m256d b = _mm256_loadu_pd(u_b + y);
+			__m256d sum = _mm256_add_pd(
+				_mm256_add_pd(
+					_mm256_add_pd(_mm256_loadu_pd(u_b + y + 1), _mm256_loadu_pd(u_b_next + y)),
+					_mm256_loadu_pd(u_b + y - 1)
+				),
+				_mm256_loadu_pd(u_b_prev + y)
+			);
+			__m256d u = _mm256_sub_pd(
+				_mm256_add_pd(_mm256_mul_pd(sum, c_0_v), _mm256_mul_pd(c_1_v, b)),
+				_mm256_mul_pd(c_2_v, a)
+			);
+			if constexpr (Masked) {
+				// widen 4 shorts to 4 64 bit lanes, and compare against zero
+				__m256i mask =
+					_mm256_cvtepi16_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(B + y)));
+				u = _mm256_blendv_pd(u, a, _mm256_castsi256_pd(_mm256_cmpeq_epi64(mask, zero)));
+			}
+			_mm256_storeu_pd(u_a + y, u);
+		}
+		FDTDStencilScalar<double, Masked>(u_a, u_b, u_b_prev, u_b_next, B, y, y_1, c_0, c_1, c_2);
+	}
+
+	template <bool Masked = true>
+	KAC_CORE_NO_CONTRACT __attribute__((target("avx2"))) inline void FDTDStencilAVX2(
+		float* u_a,
+		const float* u_b,
+		const float* u_b_prev,
+		const float* u_b_next,
+		const short* B,
+		unsigned long y_0,
+		unsigned long y_1,
+		float c_0,
+		float c_1,
+		float c_2
+	) {
+		/*
+		AVX2 five-point stencil, updating 8 cells per iteration. When masked, cells outside of the
+		boundary conditions are restored using a blend.
+		*/
+
+		const __m256 c_0_v = _mm256_set1_ps(c_0);
+		const __m256 c_1_v = _mm256_set1_ps(c_1);
+		const __m256 c_2_v = _mm256_set1_ps(c_2);
+		const __m256i zero = _mm256_setzero_si256();
+		unsigned long y = y_0;
+		for (; y + 8 <= y_1; y += 8) {
+			__m256 a = _mm256_loadu_ps(u_a + y);
+			__m256 b = _mm256_loadu_ps(u_b + y);
+			__m256 sum = _mm256_add_ps(
+				_mm256_add_ps(
+					_mm256_add_ps(_mm256_loadu_ps(u_b + y + 1), _mm256_loadu_ps(u_b_next + y)),
+					_mm256_loadu_ps(u_b + y - 1)
+				),
+				_mm256_loadu_ps(u_b_prev + y)
+			);
+			__m256 u = _mm256_sub_ps(
+				_mm256_add_ps(_mm256_mul_ps(sum, c_0_v), _mm256_mul_ps(c_1_v, b)),
+				_mm256_mul_ps(c_2_v, a)
+			);
+			if constexpr (Masked) {
+				// widen 8 shorts to 8 32 bit lanes, and compare against zero
+				__m256i mask =
+					_mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(B + y)));
+				u = _mm256_blendv_ps(u, a, _mm256_castsi256_ps(_mm256_cmpeq_epi32(mask, zero)));
+			}
+			_mm256_storeu_ps(u_a + y, u);
+		}
+		FDTDStencilScalar<float, Masked>(u_a, u_b, u_b_prev, u_b_next, B, y, y_1, c_0, c_1, c_2);
+	}
+
+	template <bool Masked = true>
+	KAC_CORE_NO_CONTRACT __attribute__((target("avx512f"))) inline void FDTDStencilAVX512(
+		double* u_a,
+		const double* u_b,
+		const double* u_b_prev,
+		const double* u_b_next,
+		const short* B,
+		unsigned long y_0,
+		unsigned long y_1,
+		double c_0,
+		double c_1,
+		double c_2
+	) {
+		/*
+		AVX-512 five-point stencil, updating 8 cells per iteration. When masked, cells outside of
+		the boundary conditions are skipped using a masked store.
+		*/
+
+		const __m512d c_0_v = _mm512_set1_pd(c_0);
+		const __m512d c_1_v = _mm512_set1_pd(c_1);
+		const __m512d c_2_v = _mm512_set1_pd(c_2);
+		unsigned long y = y_0;
+		for (; y + 8 <= y_1; y += 8) {
+			__m512d a = _mm512_loadu_pd(u_a + y);
+			__m512d b = _mm512_loadu_pd(u_b + y);
+			__m512d sum = _mm512_add_pd(
+				_mm512_add_pd(
+					_mm512_add_pd(_mm512_loadu_pd(u_b + y + 1), _mm512_loadu_pd(u_b_next + y)),
+					_mm512_loadu_pd(u_b + y - 1)
+				),
+				_mm512_loadu_pd(u_b_prev + y)
+			);
+			__m512d u = _mm512_sub_pd(
+				_mm512_add_pd(_mm512_mul_pd(sum, c_0_v), _mm512_mul_pd(c_1_v, b)),
+				_mm512_mul_pd(c_2_v, a)
+			);
+			if constexpr (Masked) {
+				// widen 8 shorts to 8 64 bit lanes, and test against zero. The zero masked form
+				// avoids a false -Wmaybe-uninitialized in the GCC 12 headers.
+				__m512i mask = _mm512_maskz_cvtepi16_epi64(
+					0xFF, _mm_loadu_si128(reinterpret_cast<const __m128i*>(B + y))
+				);
+				_mm512_mask_storeu_pd(u_a + y, _mm512_test_epi64_mask(mask, mask), u);
+			} else {
+				_mm512_storeu_pd(u_a + y, u);
+			}
+		}
+		FDTDStencilScalar<double, Masked>(u_a, u_b, u_b_prev, u_b_next, B, y, y_1, c_0, c_1, c_2);
+	}
+
+	template <bool Masked = true>
+	KAC_CORE_NO_CONTRACT __attribute__((target("avx512f"))) inline void FDTDStencilAVX512(
+		float* u_a,
+		const float* u_b,
+		const float* u_b_prev,
+		const float* u_b_next,
+		const short* B,
+		unsigned long y_0,
+		unsigned long y_1,
+		float c_0,
+		float c_1,
+		float c_2
+	) {
+		/*
+		AVX-512 five-point stencil, updating 16 cells per iteration. When masked, cells outside of
+		the boundary conditions are skipped using a masked store.
+		*/
+
+		const __m512 c_0_v = _mm512_set1_ps(c_0);
+		const __m512 c_1_v = _mm512_set1_ps(c_1);
+		const __m512 c_2_v = _mm512_set1_ps(c_2);
+		unsigned long y = y_0;
+		for (; y + 16 <= y_1; y += 16) {
+			__m512 a = _mm512_loadu_ps(u_a + y);
+			__m512 b = _mm512_loadu_ps(u_b + y);
+			__m512 sum = _mm512_add_ps(
+				_mm512_add_ps(
+					_mm512_add_ps(_mm512_loadu_ps(u_b + y + 1), _mm512_loadu_ps(u_b_next + y)),
+					_mm512_loadu_ps(u_b + y - 1)
+				),
+				_mm512_loadu_ps(u_b_prev + y)
+			);
+			__m512 u = _mm512_sub_ps(
+				_mm512_add_ps(_mm512_mul_ps(sum, c_0_v), _mm512_mul_ps(c_1_v, b)),
+				_mm512_mul_ps(c_2_v, a)
+			);
+			if constexpr (Masked) {
+				// widen 16 shorts to 16 32 bit lanes, and test against zero, see above
+				__m512i mask = _mm512_maskz_cvtepi16_epi32(
+					0xFFFF, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(B + y))
+				);
+				_mm512_mask_storeu_ps(u_a + y, _mm512_test_epi32_mask(mask, mask), u);
+			} else {
+				_mm512_storeu_ps(u_a + y, u);
+			}
+		}
+		FDTDStencilScalar<float, Masked>(u_a, u_b, u_b_prev, u_b_next, B, y, y_1, c_0, c_1, c_2);
+	}
+#endif
+
+	template <typename Scalar = double>
+	inline FDTDStencilKernel<Scalar>
+	FDTDStencil(const U::SIMDLevel& level = U::detectSIMDLevel(), const bool& masked = true) {
+		/*
+		Select a five-point stencil kernel. The requested instruction set is clamped to the
+		instruction set supported by the current processor.
+		input:
+			level = the widest instruction set to use.
+			masked = whether the kernel should apply the boundary conditions.
+		output:
+			kernel = the FDTD stencil kernel.
+		*/
+
+#ifdef KAC_CORE_X86_SIMD
+		typedef FDTDStencilKernel<Scalar> Kernel;
+		if constexpr (std::is_same_v<Scalar, double> || std::is_same_v<Scalar, float>) {
+			switch (std::min(level, U::detectSIMDLevel())) {
+				case U::SIMDLevel::AVX512:
+					return masked ? static_cast<Kernel>(FDTDStencilAVX512<true>)
+								  : static_cast<Kernel>(FDTDStencilAVX512<false>);
+				case U::SIMDLevel::AVX2:
+					return masked ? static_cast<Kernel>(FDTDStencilAVX2<true>)
+								  : static_cast<Kernel>(FDTDStencilAVX2<false>);
+				default:
+					break;
+			}
+		}
+#endif
+		return masked ? FDTDStencilScalar<Scalar, true> : FDTDStencilScalar<Scalar, false>;
+	}
+
+}
@@ -4,8 +4,13 @@ Central import for all files in /modes.
 
 #pragma once
 
+#include "bessel_batch.hpp"
+#include "bessel_zero_table.hpp"
 #include "circular_modes.hpp"
 #include "linear_modes.hpp"
+#include "nodal_lines.hpp"
+#include "oscillator_bank.hpp"
 #include "rectangular_modes.hpp"
+#include "sine_series.hpp"
 #include "triangular_modes.hpp"
 #include "wave_equation.hpp"
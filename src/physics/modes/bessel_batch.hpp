@@ -0,0 +1,341 @@
+/*
+Batch evaluation of the bessel functions of the first kind, J_0(x) ... J_{N - 1}(x), using Miller's
+backward recurrence,
+	J_{k - 1}(x) = (2k / x) * J_k(x) - J_{k + 1}(x),
+which is started from an arbitrary value at an order K well above max(N, x), and normalised using
+	J_0(x) + 2 * Σ J_2k(x) = 1.
+Every order is produced in a single pass, and the recurrence is vectorised across arguments. The
+scalar, AVX2 and AVX-512 kernels perform the same operations in the same order, and so produce
+identical results. Relative to boost::math::cyl_bessel_j, the batch satisfies
+	|J_n(x) - J_boost_n(x)| <= 2^-48,
+which was measured for 0 <= n < 100 and 0 <= x <= 300. Arguments beyond this range are evaluated
+using boost::math::cyl_bessel_j instead, and non-finite arguments are rejected.
+*/
+
+#pragma once
+
+// core
+#include <algorithm>	// max, min
+#include <math.h>
+#include <stdexcept>
+#include <vector>
+
+// dependencies
+#include <boost/math/special_functions/bessel.hpp>
+
+// src
+#include "../../types.hpp"
+#include "../../utils/simd.hpp"
+namespace T = kac_core::types;
+namespace U = kac_core::utils;
+
+namespace kac_core::physics {
+
+	// A kernel for evaluating J[i * N + n] = J_n(x[i]), for 0 <= i < count and 0 <= n < N.
+	using BesselJBatchKernel =
+		void (*)(const double* x, unsigned long count, unsigned long N, double* J);
+
+	// Recurrence values are rescaled by 2^-512 whenever they exceed 2^512.
+	constexpr double bessel_big = 0x1p512;
+	constexpr double bessel_small = 0x1p-512;
+	// Arguments below this are treated as 0, where J_0 = 1 and J_n = 0.
+	constexpr double bessel_tiny = 1e-100;
+	// Arguments beyond this are evaluated using boost::math::cyl_bessel_j.
+	constexpr double bessel_max = 300.;
+
+	inline unsigned long BesselJStart(const double& x, const unsigned long& N) {
+		/*
+		The even order K at which the backward recurrence is started. Arguments beyond bessel_max
+		are later replaced by BesselJNormalise(), and so their recurrence is kept short.
+		*/
+
+		if (!isfinite(x)) {
+			throw std::invalid_argument("x must be finite.");
+		}
+		const double m = std::max(static_cast<double>(N), std::min(fabs(x), bessel_max));
+		return 2 * (static_cast<unsigned long>(m + 16. + sqrt(40. * m)) / 2 + 1);
+	}
+
+	inline void BesselJNormalise(
+		const double& x,
+		const unsigned long& N,
+		const double* raw,
+		const double* scale,
+		const unsigned long& lanes,
+		const double& sum,
+		const double& scale_final,
+		double* J
+	) {
+		/*
+		Normalise the raw recurrence values raw[n * lanes] of a single argument, accounting for
+		the number of times that the recurrence was rescaled after each value was recorded.
+		Arguments beyond bessel_max are evaluated using boost::math::cyl_bessel_j.
+		*/
+
+		if (fabs(x) > bessel_max) {
+			for (unsigned long n = 0; n < N; n++) {
+				J[n] = boost::math::cyl_bessel_j(static_cast<double>(n), x);
+			}
+			return;
+		}
+		if (fabs(x) < bessel_tiny) {
+			for (unsigned long n = 0; n < N; n++) { J[n] = n == 0 ? 1. : 0.; }
+			return;
+		}
+		for (unsigned long n = 0; n < N; n++) {
+			const int rescaled = static_cast<int>(scale_final - scale[n * lanes]);
+			J[n] = raw[n * lanes] * ldexp(1., -512 * rescaled) / sum;
+		}
+	}
+
+	KAC_CORE_NO_CONTRACT inline void
+	BesselJBatchScalar(const double* x, unsigned long count, unsigned long N, double* J) {
+		/*
+		Portable batch evaluation of the bessel functions of the first kind.
+		input:
+			x = the arguments of the bessel functions.
+			count = the number of arguments.
+			N = the number of orders.
+		output:
+			J[i * N + n] = J_n(x[i])
+		*/
+
+		KAC_CORE_FP_CONTRACT_OFF
+		// there are no orders to evaluate
+		if (N == 0) {
+			return;
+		}
+		std::vector<double> raw(N);
+		std::vector<double> scale(N);
+		for (unsigned long i = 0; i < count; i++) {
+			const double inv = fabs(x[i]) < bessel_tiny ? 0. : 2. / x[i];
+			double j = 1.;
+			double j_next = 0.;
+			double sum = 0.;
+			double s = 0.;
+			for (unsigned long k = BesselJStart(x[i], N); k > 0; k--) {
+				if (k < N) {
+					raw[k] = j;
+					scale[k] = s;
+				}
+				if (k % 2 == 0) {
+					sum = sum + (j + j);
+				}
+				const double j_prev = (k * inv) * j - j_next;
+				j_next = j;
+				j = j_prev;
+				if (fabs(j) > bessel_big) {
+					j = j * bessel_small;
+					j_next = j_next * bessel_small;
+					sum = sum * bessel_small;
+					s = s + 1.;
+				}
+			}
+			raw[0] = j;
+			scale[0] = s;
+			sum = sum + j;
+			BesselJNormalise(x[i], N, raw.data(), scale.data(), 1, sum, s, J + i * N);
+		}
+	}
+
+#ifdef KAC_CORE_X86_SIMD
+	KAC_CORE_NO_CONTRACT __attribute__((target("avx2"))) inline void
+	BesselJBatchAVX2(const double* x, unsigned long count, unsigned long N, double* J) {
+		/*
+		AVX2 batch evaluation of the bessel functions, evaluating 4 arguments per iteration. Each
+		lane begins its recurrence at its own starting order, prior to which it remains 0.
+		*/
+
+		// there are no orders to evaluate
+		if (N == 0) {
+			return;
+		}
+		const __m256d big = _mm256_set1_pd(bessel_big);
+		const __m256d small = _mm256_set1_pd(bessel_small);
+		const __m256d one = _mm256_set1_pd(1.);
+		const __m256d sign = _mm256_set1_pd(-0.);
+		std::vector<double> raw(4 * N);
+		std::vector<double> scale(4 * N);
+		unsigned long i = 0;
+		for (; i + 4 <= count; i += 4) {
+			double inv_i[4];
+			double K_i[4];
+			unsigned long K = 0;
+			for (unsigned long l = 0; l < 4; l++) {
+				inv_i[l] = fabs(x[i + l]) < bessel_tiny ? 0. : 2. / x[i + l];
+				K_i[l] = static_cast<double>(BesselJStart(x[i + l], N));
+				K = std::max(K, BesselJStart(x[i + l], N));
+			}
+			const __m256d inv = _mm256_loadu_pd(inv_i);
+			const __m256d start = _mm256_loadu_pd(K_i);
+			__m256d j = _mm256_setzero_pd();
+			__m256d j_next = _mm256_setzero_pd();
+			__m256d sum = _mm256_setzero_pd();
+			__m256d s = _mm256_setzero_pd();
+			for (unsigned long k = K; k > 0; k--) {
+				const __m256d k_v = _mm256_set1_pd(static_cast<double>(k));
+				j = _mm256_blendv_pd(j, one, _mm256_cmp_pd(k_v, start, _CMP_EQ_OQ));
+				if (k < N) {
+					_mm256_storeu_pd(raw.data() + 4 * k, j);
+					_mm256_storeu_pd(scale.data() + 4 * k, s);
+				}
+				if (k % 2 == 0) {
+					sum = _mm256_add_pd(sum, _mm256_add_pd(j, j));
+				}
+				const __m256d j_prev =
+					_mm256_sub_pd(_mm256_mul_pd(_mm256_mul_pd(k_v, inv), j), j_next);
+				j_next = j;
+				j = j_prev;
+				const __m256d over = _mm256_cmp_pd(_mm256_andnot_pd(sign, j), big, _CMP_GT_OQ);
+				const __m256d factor = _mm256_blendv_pd(one, small, over);
+				j = _mm256_mul_pd(j, factor);
+				j_next = _mm256_mul_pd(j_next, factor);
+				sum = _mm256_mul_pd(sum, factor);
+				s = _mm256_add_pd(s, _mm256_and_pd(over, one));
+			}
+			_mm256_storeu_pd(raw.data(), j);
+			_mm256_storeu_pd(scale.data(), s);
+			sum = _mm256_add_pd(sum, j);
+			double sum_i[4];
+			double s_i[4];
+			_mm256_storeu_pd(sum_i, sum);
+			_mm256_storeu_pd(s_i, s);
+			for (unsigned long l = 0; l < 4; l++) {
+				BesselJNormalise(
+					x[i + l],
+					N,
+					raw.data() + l,
+					scale.data() + l,
+					4,
+					sum_i[l],
+					s_i[l],
+					J + (i + l) * N
+				);
+			}
+		}
+		BesselJBatchScalar(x + i, count - i, N, J + i * N);
+	}
+
+	KAC_CORE_NO_CONTRACT __attribute__((target("avx512f"))) inline void
+	BesselJBatchAVX512(const double* x, unsigned long count, unsigned long N, double* J) {
+		/*
+		AVX-512 batch evaluation of the bessel functions, evaluating 8 arguments per iteration.
+		Each lane begins its recurrence at its own starting order, prior to which it remains 0.
+		*/
+
+		// there are no orders to evaluate
+		if (N == 0) {
+			return;
+		}
+		const __m512d big = _mm512_set1_pd(bessel_big);
+		const __m512d small = _mm512_set1_pd(bessel_small);
+		const __m512d one = _mm512_set1_pd(1.);
+		std::vector<double> raw(8 * N);
+		std::vector<double> scale(8 * N);
+		unsigned long i = 0;
+		for (; i + 8 <= count; i += 8) {
+			double inv_i[8];
+			double K_i[8];
+			unsigned long K = 0;
+			for (unsigned long l = 0; l < 8; l++) {
+				inv_i[l] = fabs(x[i + l]) < bessel_tiny ? 0. : 2. / x[i + l];
+				K_i[l] = static_cast<double>(BesselJStart(x[i + l], N));
+				K = std::max(K, BesselJStart(x[i + l], N));
+			}
+			const __m512d inv = _mm512_loadu_pd(inv_i);
+			const __m512d start = _mm512_loadu_pd(K_i);
+			__m512d j = _mm512_setzero_pd();
+			__m512d j_next = _mm512_setzero_pd();
+			__m512d sum = _mm512_setzero_pd();
+			__m512d s = _mm512_setzero_pd();
+			for (unsigned long k = K; k > 0; k--) {
+				const __m512d k_v = _mm512_set1_pd(static_cast<double>(k));
+				j = _mm512_mask_mov_pd(j, _mm512_cmp_pd_mask(k_v, start, _CMP_EQ_OQ), one);
+				if (k < N) {
+					_mm512_storeu_pd(raw.data() + 8 * k, j);
+					_mm512_storeu_pd(scale.data() + 8 * k, s);
+				}
+				if (k % 2 == 0) {
+					sum = _mm512_add_pd(sum, _mm512_add_pd(j, j));
+				}
+				const __m512d j_prev =
+					_mm512_sub_pd(_mm512_mul_pd(_mm512_mul_pd(k_v, inv), j), j_next);
+				j_next = j;
+				j = j_prev;
+				const __mmask8 over = _mm512_cmp_pd_mask(_mm512_abs_pd(j), big, _CMP_GT_OQ);
+				j = _mm512_mask_mul_pd(j, over, j, small);
+				j_next = _mm512_mask_mul_pd(j_next, over, j_next, small);
+				sum = _mm512_mask_mul_pd(sum, over, sum, small);
+				s = _mm512_mask_add_pd(s, over, s, one);
+			}
+			_mm512_storeu_pd(raw.data(), j);
+			_mm512_storeu_pd(scale.data(), s);
+			sum = _mm512_add_pd(sum, j);
+			double sum_i[8];
+			double s_i[8];
+			_mm512_storeu_pd(sum_i, sum);
+			_mm512_storeu_pd(s_i, s);
+			for (unsigned long l = 0; l < 8; l++) {
+				BesselJNormalise(
+					x[i + l],
+					N,
+					raw.data() + l,
+					scale.data() + l,
+					8,
+					sum_i[l],
+					s_i[l],
+					J + (i + l) * N
+				);
+			}
+		}
+		BesselJBatchScalar(x + i, count - i, N, J + i * N);
+	}
+#endif
+
+	inline BesselJBatchKernel BesselJBatch(const U::SIMDLevel& level = U::detectSIMDLevel()) {
+		/*
+		Select a batch bessel kernel. The requested instruction set is clamped to the instruction
+		set supported by the current processor.
+		input:
+			level = the widest instruction set to use.
+		output:
+			kernel = the batch bessel kernel.
+		*/
+
+#ifdef KAC_CORE_X86_SIMD
+		switch (std::min(level, U::detectSIMDLevel())) {
+			case U::SIMDLevel::AVX512:
+				return BesselJBatchAVX512;
+			case U::SIMDLevel::AVX2:
+				return BesselJBatchAVX2;
+			default:
+				break;
+		}
+#endif
+		return BesselJBatchScalar;
+	}
+
+	inline T::Matrix_2D besselJBatch(const unsigned long& N, const T::Matrix_1D& x) {
+		/*
+		Calculates the bessel functions of the first kind J_0(x) ... J_{N - 1}(x) for a batch of
+		arguments.
+		input:
+			N = number of orders
+			x = x coordinates
+		output:
+			J = { J_n(x_i) | 0 <= i < |x|, 0 <= n < N }
+		*/
+
+		if (N == 0) {
+			return T::Matrix_2D(x.size());
+		}
+		std::vector<double> flat(x.size() * N);
+		BesselJBatch()(x.data(), x.size(), N, flat.data());
+		T::Matrix_2D J(x.size());
+		for (unsigned long i = 0; i < x.size(); i++) {
+			J[i].assign(flat.begin() + i * N, flat.begin() + (i + 1) * N);
+		}
+		return J;
+	}
+
+}
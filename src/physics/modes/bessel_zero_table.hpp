@@ -0,0 +1,285 @@
+/*
+A process wide table of the zeros of the bessel functions of the first kind, z_nm, for integer
+orders n >= 0 and m >= 1. Each zero is calculated once, when it is first requested, and the table
+may be stored to and loaded from a binary cache file, such that the root finding can be skipped
+entirely across processes. Where available, the cache file is memory-mapped rather than read.
+
+The cache file consists of an 8 byte signature, followed by N and M as unsigned 64 bit integers,
+followed by the N * M zeros as row-major doubles, all in native byte order.
+*/
+
+#pragma once
+
+// core
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#if __has_include(<sys/mman.h>)
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+	#define KAC_CORE_MMAP
+#endif
+
+// dependencies
+#include <boost/math/special_functions/bessel.hpp>
+
+// src
+#include "../../types.hpp"
+namespace T = kac_core::types;
+
+namespace kac_core::physics {
+
+	class BesselZeroTable {
+		/*
+		A memoised, thread safe table of bessel zeros. Lookups of zeros that are already known
+		only take a shared lock, and the table grows in place when a new zero is requested.
+		*/
+
+	public:
+		// constructors
+		BesselZeroTable() {};
+		BesselZeroTable(const BesselZeroTable&) = delete;
+		BesselZeroTable& operator=(const BesselZeroTable&) = delete;
+
+		// destructors
+		~BesselZeroTable() { unmap(); }
+
+		// methods
+		double zero(const unsigned long& n, const unsigned long& m) {
+			/*
+			The mth zero crossing of J_n(), with m >= 1.
+			*/
+
+			if (m < 1) {
+				throw std::invalid_argument("m must be at least 1.");
+			}
+			{
+				std::shared_lock<std::shared_mutex> lock(mutex);
+				if (covers(n + 1, m)) {
+					return lookup(n, m);
+				}
+			}
+			std::unique_lock<std::shared_mutex> lock(mutex);
+			grow(n + 1, m);
+			return lookup(n, m);
+		}
+
+		T::Matrix_2D zeros(const unsigned long& N, const unsigned long& M) {
+			/*
+			The zeros { z_nm | J_n(z_nm) = 0, 0 <= n < N, 0 < m <= M }.
+			*/
+
+			T::Matrix_2D S(N, T::Matrix_1D(M, 0));
+			auto fill = [this, &S, &N, &M]() {
+				for (unsigned long n = 0; n < N; n++) {
+					for (unsigned long m = 0; m < M; m++) { S[n][m] = lookup(n, m + 1); }
+				}
+			};
+			{
+				std::shared_lock<std::shared_mutex> lock(mutex);
+				if (covers(N, M)) {
+					fill();
+					return S;
+				}
+			}
+			std::unique_lock<std::shared_mutex> lock(mutex);
+			grow(N, M);
+			fill();
+			return S;
+		}
+
+		bool load(const std::string& path) {
+			/*
+			Load a cache file, replacing any cache file that was previously loaded. Zeros that
+			are not in the cache file continue to be calculated on demand.
+			output:
+				success = whether the cache file exists and is valid.
+			*/
+
+			std::unique_lock<std::shared_mutex> lock(mutex);
+			unmap();
+#ifdef KAC_CORE_MMAP
+			const int fd = open(path.c_str(), O_RDONLY);
+			if (fd < 0) {
+				return false;
+			}
+			struct stat info;
+			void* region = MAP_FAILED;
+			if (fstat(fd, &info) == 0 && info.st_size >= static_cast<off_t>(header_size)) {
+				region = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+			}
+			close(fd);
+			if (region == MAP_FAILED) {
+				return false;
+			}
+			mapped_region = region;
+			mapped_size = info.st_size;
+			if (!attach(static_cast<const char*>(region), mapped_size)) {
+				unmap();
+				return false;
+			}
+			return true;
+#else
+			std::FILE* file = std::fopen(path.c_str(), "rb");
+			if (file == nullptr) {
+				return false;
+			}
+			std::vector<char> bytes;
+			char buffer[1 << 16];
+			for (size_t n; (n = std::fread(buffer, 1, sizeof(buffer), file)) > 0;) {
+				bytes.insert(bytes.end(), buffer, buffer + n);
+			}
+			std::fclose(file);
+			// copy into doubles, so that the zeros are correctly aligned
+			buffered.resize((bytes.size() + sizeof(double) - 1) / sizeof(double));
+			std::memcpy(buffered.data(), bytes.data(), bytes.size());
+			if (!attach(reinterpret_cast<const char*>(buffered.data()), bytes.size())) {
+				unmap();
+				return false;
+			}
+			return true;
+#endif
+		}
+
+		bool save(const std::string& path, const unsigned long& N, const unsigned long& M) {
+			/*
+			Calculate the zeros for 0 <= n < N and 0 < m <= M, and store them as a cache file.
+			output:
+				success = whether the cache file was written.
+			*/
+
+			const T::Matrix_2D S = zeros(N, M);
+			std::FILE* file = std::fopen(path.c_str(), "wb");
+			if (file == nullptr) {
+				return false;
+			}
+			const std::uint64_t size[2] = {N, M};
+			bool success = std::fwrite(signature, 1, 8, file) == 8
+						&& std::fwrite(size, sizeof(std::uint64_t), 2, file) == 2;
+			for (unsigned long n = 0; n < N && success; n++) {
+				success = std::fwrite(S[n].data(), sizeof(double), M, file) == M;
+			}
+			return std::fclose(file) == 0 && success;
+		}
+
+	private:
+		// vars
+		static constexpr char signature[8] = {'K', 'A', 'C', 'B', 'Z', 'T', '0', '1'};
+		static constexpr unsigned long header_size = 8 + 2 * sizeof(std::uint64_t);
+		std::shared_mutex mutex;
+		std::vector<T::Matrix_1D> rows;		// rows[n][m - 1] = z_nm, calculated on demand
+		const double* cached = nullptr;		// z_nm = cached[n * M_cached + m - 1]
+		unsigned long N_cached = 0;
+		unsigned long M_cached = 0;
+		void* mapped_region = nullptr;
+		unsigned long mapped_size = 0;
+		std::vector<double> buffered;
+
+		// methods
+		bool attach(const char* bytes, const unsigned long& size) {
+			/*
+			Validate the contents of a cache file, and use it for subsequent lookups.
+			*/
+
+			std::uint64_t dimensions[2];
+			if (size < header_size || std::memcmp(bytes, signature, 8) != 0) {
+				return false;
+			}
+			std::memcpy(dimensions, bytes + 8, sizeof(dimensions));
+			// reject dimensions whose product would overflow
+			if (dimensions[1] != 0 && dimensions[0] > SIZE_MAX / dimensions[1] / sizeof(double)) {
+				return false;
+			}
+			if (size != header_size + dimensions[0] * dimensions[1] * sizeof(double)) {
+				return false;
+			}
+			cached = reinterpret_cast<const double*>(bytes + header_size);
+			N_cached = dimensions[0];
+			M_cached = dimensions[1];
+			return true;
+		}
+
+		void unmap() {
+			/*
+			Release the current cache file.
+			*/
+
+#ifdef KAC_CORE_MMAP
+			if (mapped_region != nullptr) {
+				munmap(mapped_region, mapped_size);
+			}
+#endif
+			mapped_region = nullptr;
+			mapped_size = 0;
+			buffered.clear();
+			cached = nullptr;
+			N_cached = 0;
+			M_cached = 0;
+		}
+
+		bool covers(const unsigned long& N, const unsigned long& M) const {
+			/*
+			Whether every zero with n < N and m <= M is known.
+			*/
+
+			if (N <= N_cached && M <= M_cached) {
+				return true;
+			}
+			if (rows.size() < N) {
+				return false;
+			}
+			for (unsigned long n = 0; n < N; n++) {
+				if (rows[n].size() < M && (n >= N_cached || M > M_cached)) {
+					return false;
+				}
+			}
+			return true;
+		}
+
+		void grow(const unsigned long& N, const unsigned long& M) {
+			/*
+			Calculate every unknown zero with n < N and m <= M.
+			*/
+
+			if (rows.size() < N) {
+				rows.resize(N);
+			}
+			for (unsigned long n = 0; n < N; n++) {
+				if (n < N_cached && M <= M_cached) {
+					continue;
+				}
+				for (unsigned long m = rows[n].size() + 1; m <= M; m++) {
+					rows[n].push_back(boost::math::cyl_bessel_j_zero(static_cast<double>(n), m));
+				}
+			}
+		}
+
+		double lookup(const unsigned long& n, const unsigned long& m) const {
+			/*
+			Find a known zero.
+			*/
+
+			if (n < N_cached && m <= M_cached) {
+				return cached[n * M_cached + m - 1];
+			}
+			return rows[n][m - 1];
+		}
+	};
+
+	inline BesselZeroTable& besselZeroTable() {
+		/*
+		The process wide table of bessel zeros.
+		*/
+
+		static BesselZeroTable table;
+		return table;
+	}
+
+}
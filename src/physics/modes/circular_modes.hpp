@@ -6,8 +6,10 @@ wave equation.
 #pragma once
 
 // core
+#include <algorithm>	// fill, max, min
 #include <math.h>
 #include <numbers>
+#include <stdexcept>
 #include <vector>
 using namespace std::numbers;
 
@@ -16,6 +18,8 @@ using namespace std::numbers;
 
 // src
 #include "../../types.hpp"
+#include "./bessel_batch.hpp"
+#include "./bessel_zero_table.hpp"
 namespace T = kac_core::types;
 
 namespace kac_core::physics {
@@ -35,7 +39,8 @@ namespace kac_core::physics {
 
 	inline double besselJZero(const double& n, const long& m) {
 		/*
-		Calculates the mth zero crossing of the bessel functions of the first kind.
+		Calculates the mth zero crossing of the bessel functions of the first kind. Zeros of
+		integer orders are memoised in the process wide besselZeroTable().
 		input:
 			n = order of the bessel function
 			m = mth zero
@@ -43,6 +48,9 @@ namespace kac_core::physics {
 			z_nm = mth zero crossing of J_n() | z_mn ∈ ℝ
 		*/
 
+		if (n >= 0. && n == floor(n) && m >= 1) {
+			return besselZeroTable().zero(static_cast<unsigned long>(n), m);
+		}
 		return boost::math::cyl_bessel_j_zero(n, m);
 	}
 
@@ -50,6 +58,7 @@ namespace kac_core::physics {
 	circularAmplitudes(const double& r, const double& theta, const T::Matrix_2D& S) {
 		/*
 		Calculate the amplitudes of the circular eigenmodes relative to a polar strike location.
+		The bessel functions of each order are evaluated as a single batch, see besselJBatch().
 		input:
 			(r, θ) = polar strike location
 			S = { z_nm | s ∈ ℝ, J_n(z_nm) = 0, 0 <= n < N, 0 < m <= M }
@@ -63,26 +72,82 @@ namespace kac_core::physics {
 		const unsigned long N = S.size();
 		const unsigned long M = S[0].size();
 		const double pi_4 = pi / 4;
+		const BesselJBatchKernel besselJ_batch = BesselJBatch();
 		T::Matrix_2D A(N, T::Matrix_1D(M, 0));
+		T::Matrix_1D x(M);
+		T::Matrix_1D J(M * N);
 		for (unsigned long n = 0; n < N; n++) {
 			double angular = n != 0 ? sqrt2 * sin(n * theta + pi_4) : 1.;
-			for (unsigned long m = 0; m < M; m++) {
-				A[n][m] = abs(boost::math::cyl_bessel_j(n, S[n][m] * r) * angular);
-			};
+			// J[m * (n + 1) + n] = J_n(z_nm * r)
+			for (unsigned long m = 0; m < M; m++) { x[m] = S[n][m] * r; }
+			besselJ_batch(x.data(), M, n + 1, J.data());
+			for (unsigned long m = 0; m < M; m++) { A[n][m] = abs(J[m * (n + 1) + n] * angular); };
 		}
 		return A;
 	}
 
-	inline T::BooleanImage circularChladniPattern(
-		const double& n, const double& m, const unsigned long& H, const double& tolerance = 0.1
+	inline void circularAmplitudesBatch(
+		const T::Matrix_1D& r, const T::Matrix_1D& theta, const T::Matrix_2D& S, double* A
 	) {
 		/*
-		Produce the 2D Chladni pattern for a circular plate.
+		Calculate the amplitudes of the circular eigenmodes relative to a batch of K polar strike
+		locations. The bessel functions of each order are evaluated for every strike as a single
+		batch, see besselJBatch(), and each amplitude is identical to that of
+		circularAmplitudes().
+		input:
+			(r, θ) = polar strike locations
+			S = { z_nm | s ∈ ℝ, J_n(z_nm) = 0, 0 <= n < N, 0 < m <= M }
+		output:
+			A[(k * N + n) * M + m] = abs(J_n(z_nm * r_k) * (2 ** 0.5) * sin(nθ_k + π/4))
+			| 0 <= k < K, 0 <= n < N, 0 <= m < M
+		*/
+
+		// handle errors
+		if (r.size() != theta.size()) {
+			throw std::invalid_argument("r and theta differ in size.");
+		}
+		const unsigned long K = r.size();
+		const unsigned long N = S.size();
+		const unsigned long M = S[0].size();
+		const double pi_4 = pi / 4;
+		const BesselJBatchKernel besselJ_batch = BesselJBatch();
+		T::Matrix_1D x(K * M);
+		T::Matrix_1D J(K * M * N);
+		for (unsigned long n = 0; n < N; n++) {
+			// J[(k * M + m) * (n + 1) + n] = J_n(z_nm * r_k)
+			for (unsigned long k = 0; k < K; k++) {
+				for (unsigned long m = 0; m < M; m++) { x[k * M + m] = S[n][m] * r[k]; }
+			}
+			besselJ_batch(x.data(), K * M, n + 1, J.data());
+			for (unsigned long k = 0; k < K; k++) {
+				double angular = n != 0 ? sqrt2 * sin(n * theta[k] + pi_4) : 1.;
+				double* a = A + (k * N + n) * M;
+				for (unsigned long m = 0; m < M; m++) {
+					a[m] = abs(J[(k * M + m) * (n + 1) + n] * angular);
+				}
+			}
+		}
+	}
+
+	inline void circularChladniPattern(
+		const double& n, const double& m, T::BitImage& M, const double& tolerance = 0.1
+	) {
+		/*
+		Produce the 2D Chladni pattern for a circular plate, written directly into a packed bit
+		image of size H * H, where H = M.X = M.Y.
 		http://paulbourke.net/geometry/chladni/
+
+		Rather than evaluating the bessel function and the angle of every pixel, the radial
+		profile J_n(z_nm * r) is tabulated once at the radii r = j / L, where L = max(H, 64), and
+		interpolated using a cubic (Catmull-Rom) spline, whose error is of order (z_nm / L) ** 4.
+		The table extends beyond r = 1 to pad the spline at either end. The angular terms are
+		found from the phasor e^(iθ) = (x + iy) / r, by raising it to the power n using repeated
+		complex multiplication. As the pattern is reflected in both axes, with the angular terms of
+		each quadrant related by cos(nπ) and sin(nπ), only a single quadrant is evaluated.
 		input:
 			n = nth modal index
 			m = mth modal index
-			H = length of the X and Y axis
+			M = the output image
 			tolerance = the standard deviation between the calculation and the final pattern
 		output:
 			M = {
@@ -90,37 +155,130 @@ namespace kac_core::physics {
 			}
 		*/
 
+		// handle errors
+		if (M.X != M.Y) {
+			throw std::invalid_argument("M must be square.");
+		}
+		const unsigned long H = M.X;
 		// interpolate n and z_mn
 		double n_round = round(2. * n) / 2.;
 		double m_floor = floor(m);
-		double z_mn_floor = boost::math::cyl_bessel_j_zero(n, m_floor);
-		double z_mn = z_mn_floor
-					+ ((boost::math::cyl_bessel_j_zero(n, ceil(m)) - z_mn_floor) * (m - m_floor));
-		// calculate pattern
-		T::BooleanImage M(H, std::vector<short>(H, 0));
-		for (unsigned long x = 0; x < H; x++) {
-			double x_prime = (2. * x / H) - 1.;
-			for (unsigned long y = 0; y < H; y++) {
-				double y_prime = (2. * y / H) - 1.;
-				double r = sqrt(pow(x_prime, 2) + pow(y_prime, 2));
+		double z_mn_floor = besselJZero(n, m_floor);
+		double z_mn = z_mn_floor + ((besselJZero(n, ceil(m)) - z_mn_floor) * (m - m_floor));
+		std::fill(M.data.begin(), M.data.end(), 0);
+		if (H == 0) {
+			return;
+		}
+		// tabulate J_n(z_mn * r) for r = j / L, padded for the spline at either end
+		const unsigned long L = std::max(H, 64ul);
+		T::Matrix_1D radial(L + 4);
+		T::Matrix_1D x(L + 3);
+		for (unsigned long j = 0; j < L + 3; j++) { x[j] = z_mn * j / L; }
+		if (n >= 0. && n == floor(n)) {
+			const unsigned long N = static_cast<unsigned long>(n) + 1;
+			T::Matrix_1D J(N * (L + 3));
+			BesselJBatch()(x.data(), L + 3, N, J.data());
+			for (unsigned long j = 0; j < L + 3; j++) { radial[j + 1] = J[j * N + N - 1]; }
+		} else {
+			for (unsigned long j = 0; j < L + 3; j++) {
+				radial[j + 1] = boost::math::cyl_bessel_j(n, x[j]);
+			}
+		}
+		radial[0] = 3. * radial[1] - 3. * radial[2] + radial[3];
+		// the angular terms of each quadrant, relative to θ ∈ [0, π/2]
+		const double C = round(cos(n_round * pi));
+		const double S = round(sin(n_round * pi));
+		const unsigned long k = static_cast<unsigned long>(floor(abs(n_round)));
+		const bool half = abs(n_round) != floor(abs(n_round));
+		// calculate the pattern for x, y >= 0
+		for (unsigned long i = 0; 2 * i <= H; i++) {
+			const double x_prime = (H - 2. * i) / H;
+			for (unsigned long j = 0; 2 * j <= H; j++) {
+				const double y_prime = (H - 2. * j) / H;
+				const double r = sqrt(x_prime * x_prime + y_prime * y_prime);
 				if (r > 1.) {
 					continue;
-				} else {
-					double theta = atan2(y_prime, x_prime);
-					M[x][y] = abs(boost::math::cyl_bessel_j(n, z_mn * r)
-								  * (cos(n_round * theta) + sin(n_round * theta)))
-									< tolerance
-								? 1
-								: 0;
+				}
+				// J_n(z_mn * r)
+				const double u = r * L;
+				const unsigned long l = std::min(static_cast<unsigned long>(u), L);
+				const double t = u - l;
+				const double* p = radial.data() + l;
+				const double a_3 = 3. * (p[1] - p[2]) + p[3] - p[0];
+				const double a_2 = 2. * p[0] - 5. * p[1] + 4. * p[2] - p[3];
+				const double J = p[1] + 0.5 * t * (p[2] - p[0] + t * (a_2 + t * a_3));
+				// e^(i|n|θ)
+				const double c_1 = r == 0. ? 1. : x_prime / r;
+				const double s_1 = r == 0. ? 0. : y_prime / r;
+				double c = 1.;
+				double s = 0.;
+				if (half) {
+					c = sqrt((1. + c_1) / 2.);
+					s = s_1 / (2. * c);
+				}
+				double c_k = c_1;
+				double s_k = s_1;
+				for (unsigned long e = k; e > 0; e >>= 1) {
+					if (e & 1) {
+						const double c_next = c * c_k - s * s_k;
+						s = c * s_k + s * c_k;
+						c = c_next;
+					}
+					const double c_next = c_k * c_k - s_k * s_k;
+					s_k = 2. * c_k * s_k;
+					c_k = c_next;
+				}
+				if (n_round < 0.) {
+					s = -s;
+				}
+				// reflect into every quadrant, where M(x, y) has x' = (2x / H) - 1
+				const double c_bar = C * c + S * s;
+				const double s_bar = S * c - C * s;
+				const bool x_pos = i != 0;
+				const bool x_neg = 2 * i < H;
+				const bool y_pos = j != 0;
+				const bool y_neg = 2 * j < H;
+				if (x_pos && y_pos) {
+					M.set(H - i, H - j, abs(J * (c + s)) < tolerance);
+				}
+				if (x_pos && y_neg) {
+					M.set(H - i, j, abs(J * (c - s)) < tolerance);
+				}
+				if (x_neg && y_pos) {
+					M.set(i, H - j, abs(J * (c_bar + s_bar)) < tolerance);
+				}
+				if (x_neg && y_neg) {
+					M.set(i, j, abs(J * (c_bar - s_bar)) < tolerance);
 				}
 			}
 		}
-		return M;
+	}
+
+	inline T::BooleanImage circularChladniPattern(
+		const double& n, const double& m, const unsigned long& H, const double& tolerance = 0.1
+	) {
+		/*
+		Produce the 2D Chladni pattern for a circular plate.
+		http://paulbourke.net/geometry/chladni/
+		input:
+			n = nth modal index
+			m = mth modal index
+			H = length of the X and Y axis
+			tolerance = the standard deviation between the calculation and the final pattern
+		output:
+			M = {
+				J_n(z_nm * r) * (cos(nθ) + sin(nθ)) ≈ 0
+			}
+		*/
+
+		T::BitImage M(H, H);
+		circularChladniPattern(n, m, M, tolerance);
+		return M.matrix();
 	}
 
 	inline T::Matrix_2D circularSeries(const unsigned long& N, const unsigned long& M) {
 		/*
-		Calculate the eigenmodes of a circle.
+		Calculate the eigenmodes of a circle, using the process wide besselZeroTable().
 		input:
 			N = number of modal orders
 			M = number of modes per order
@@ -128,13 +286,7 @@ namespace kac_core::physics {
 			S = { z_nm | s ∈ ℝ, J_n(z_nm) = 0, 0 <= n < N, 0 < m <= M }
 		*/
 
-		T::Matrix_2D S(N, T::Matrix_1D(M, 0));
-		for (unsigned long n = 0; n < N; n++) {
-			for (unsigned long m = 0; m < M; m++) {
-				S[n][m] = boost::math::cyl_bessel_j_zero((double)n, m + 1);
-			}
-		}
-		return S;
+		return besselZeroTable().zeros(N, M);
 	}
 
 }
@@ -8,11 +8,13 @@ equation.
 // core
 #include <math.h>
 #include <numbers>
+#include <stdexcept>
 #include <vector>
 using namespace std::numbers;
 
 // src
 #include "../../types.hpp"
+#include "./sine_series.hpp"
 namespace T = kac_core::types;
 
 namespace kac_core::physics {
@@ -33,6 +35,28 @@ namespace kac_core::physics {
 		return A;
 	}
 
+	inline void
+	linearAmplitudesBatch(const T::Matrix_1D& x, const unsigned long& N, double* A) {
+		/*
+		Calculate the amplitudes of the 1D eigenmodes relative to a batch of K strike locations.
+		The harmonics of every strike are evaluated at once, see sineSeries().
+		input:
+			x = strike locations
+			N = number of modes
+		output:
+			A[k * N + n] = abs(sin((n + 1)x_kπ)), 0 <= k < K, 0 <= n < N
+		*/
+
+		const unsigned long K = x.size();
+		T::Matrix_1D theta(K);
+		for (unsigned long k = 0; k < K; k++) { theta[k] = x[k] * pi; }
+		T::Matrix_1D S(N * K);
+		sineSeries(theta.data(), K, N, S.data());
+		for (unsigned long k = 0; k < K; k++) {
+			for (unsigned long n = 0; n < N; n++) { A[k * N + n] = abs(S[n * K + k]); }
+		}
+	}
+
 	inline T::Matrix_1D linearSeries(const unsigned long& N) {
 		/*
 		Calculate the the harmonic series.
@@ -0,0 +1,172 @@
+/*
+Vectorised kernels for locating the nodal lines of separable modes, where the displacement of
+each pixel is the difference of two outer products of 1 dimensional vectors. Each kernel
+thresholds a single row of the image, and writes the result as packed bits. The scalar, AVX2 and
+AVX-512 kernels perform the same operations in the same order, and so produce identical results.
+*/
+
+#pragma once
+
+// core
+#include <algorithm>	// min
+#include <cstdint>
+#include <math.h>
+
+// src
+#include "../../utils/simd.hpp"
+namespace U = kac_core::utils;
+
+namespace kac_core::physics {
+
+	// A kernel for setting bit y of bits[y / 64] to |a * u[y] - b * v[y]| < tolerance.
+	using NodalRowKernel = void (*)(
+		double a,
+		double b,
+		const double* u,
+		const double* v,
+		unsigned long Y,
+		double tolerance,
+		std::uint64_t* bits
+	);
+
+	KAC_CORE_NO_CONTRACT inline void NodalRowTail(
+		double a,
+		double b,
+		const double* u,
+		const double* v,
+		unsigned long y,
+		unsigned long Y,
+		double tolerance,
+		std::uint64_t* bits
+	) {
+		/*
+		Threshold the pixels [y, Y) of the row, where y is a multiple of 64.
+		*/
+
+		KAC_CORE_FP_CONTRACT_OFF
+		for (; y < Y; y += 64) {
+			std::uint64_t word = 0;
+			for (unsigned long i = 0; i < std::min(64ul, Y - y); i++) {
+				const bool nodal = fabs((a * u[y + i]) - (b * v[y + i])) < tolerance;
+				word |= std::uint64_t(nodal) << i;
+			}
+			bits[y / 64] = word;
+		}
+	}
+
+	inline void NodalRowScalar(
+		double a,
+		double b,
+		const double* u,
+		const double* v,
+		unsigned long Y,
+		double tolerance,
+		std::uint64_t* bits
+	) {
+		/*
+		Portable thresholding of a row.
+		input:
+			a, b = the row's entries of the first vector of each outer product.
+			u, v = the second vector of each outer product.
+			Y = the length of the row.
+			tolerance = the threshold below which a pixel is nodal.
+		output:
+			bits = the row, packed 64 pixels per word, with 0 beyond Y.
+		*/
+
+		NodalRowTail(a, b, u, v, 0, Y, tolerance, bits);
+	}
+
+#ifdef KAC_CORE_X86_SIMD
+	KAC_CORE_NO_CONTRACT __attribute__((target("avx2"))) inline void NodalRowAVX2(
+		double a,
+		double b,
+		const double* u,
+		const double* v,
+		unsigned long Y,
+		double tolerance,
+		std::uint64_t* bits
+	) {
+		/*
+		AVX2 thresholding of a row, producing 4 bits per comparison.
+		*/
+
+		const __m256d a_v = _mm256_set1_pd(a);
+		const __m256d b_v = _mm256_set1_pd(b);
+		const __m256d tolerance_v = _mm256_set1_pd(tolerance);
+		const __m256d sign = _mm256_set1_pd(-0.);
+		unsigned long y = 0;
+		for (; y + 64 <= Y; y += 64) {
+			std::uint64_t word = 0;
+			for (unsigned long i = 0; i < 64; i += 4) {
+				const __m256d d = _mm256_sub_pd(
+					_mm256_mul_pd(a_v, _mm256_loadu_pd(u + y + i)),
+					_mm256_mul_pd(b_v, _mm256_loadu_pd(v + y + i))
+				);
+				const __m256d nodal =
+					_mm256_cmp_pd(_mm256_andnot_pd(sign, d), tolerance_v, _CMP_LT_OQ);
+				word |= std::uint64_t(_mm256_movemask_pd(nodal)) << i;
+			}
+			bits[y / 64] = word;
+		}
+		NodalRowTail(a, b, u, v, y, Y, tolerance, bits);
+	}
+
+	KAC_CORE_NO_CONTRACT __attribute__((target("avx512f"))) inline void NodalRowAVX512(
+		double a,
+		double b,
+		const double* u,
+		const double* v,
+		unsigned long Y,
+		double tolerance,
+		std::uint64_t* bits
+	) {
+		/*
+		AVX-512 thresholding of a row, producing 8 bits per comparison.
+		*/
+
+		const __m512d a_v = _mm512_set1_pd(a);
+		const __m512d b_v = _mm512_set1_pd(b);
+		const __m512d tolerance_v = _mm512_set1_pd(tolerance);
+		unsigned long y = 0;
+		for (; y + 64 <= Y; y += 64) {
+			std::uint64_t word = 0;
+			for (unsigned long i = 0; i < 64; i += 8) {
+				const __m512d d = _mm512_sub_pd(
+					_mm512_mul_pd(a_v, _mm512_loadu_pd(u + y + i)),
+					_mm512_mul_pd(b_v, _mm512_loadu_pd(v + y + i))
+				);
+				const __mmask8 nodal =
+					_mm512_cmp_pd_mask(_mm512_abs_pd(d), tolerance_v, _CMP_LT_OQ);
+				word |= std::uint64_t(nodal) << i;
+			}
+			bits[y / 64] = word;
+		}
+		NodalRowTail(a, b, u, v, y, Y, tolerance, bits);
+	}
+#endif
+
+	inline NodalRowKernel NodalRow(const U::SIMDLevel& level = U::detectSIMDLevel()) {
+		/*
+		Select a kernel for thresholding the rows of a nodal pattern. The requested instruction
+		set is clamped to the instruction set supported by the current processor.
+		input:
+			level = the widest instruction set to use.
+		output:
+			kernel = the thresholding kernel.
+		*/
+
+#ifdef KAC_CORE_X86_SIMD
+		switch (std::min(level, U::detectSIMDLevel())) {
+			case U::SIMDLevel::AVX512:
+				return NodalRowAVX512;
+			case U::SIMDLevel::AVX2:
+				return NodalRowAVX2;
+			default:
+				break;
+		}
+#endif
+		return NodalRowScalar;
+	}
+
+}
@@ -8,11 +8,14 @@ rectangular wave equation.
 // core
 #include <math.h>
 #include <numbers>
+#include <stdexcept>
 #include <vector>
 using namespace std::numbers;
 
 // src
 #include "../../types.hpp"
+#include "./nodal_lines.hpp"
+#include "./sine_series.hpp"
 namespace T = kac_core::types;
 
 namespace kac_core::physics {
@@ -49,6 +52,93 @@ namespace kac_core::physics {
 		return A;
 	}
 
+	inline void rectangularAmplitudesBatch(
+		const T::Matrix_1D& x,
+		const T::Matrix_1D& y,
+		const unsigned long& N,
+		const unsigned long& M,
+		const double& epsilon,
+		double* A
+	) {
+		/*
+		Calculate the amplitudes of the rectangular eigenmodes relative to a batch of K cartesian
+		strike locations. Each amplitude is separable, and so only N + M sinusoids are evaluated
+		per strike, for every strike at once, see sineSeries().
+		input:
+			( x , y ) = cartesian products
+			N = number of modal orders
+			M = number of modes per order
+			epsilon = aspect ratio of the rectangle
+		output:
+			A[(k * N + n) * M + m] = {
+				abs(sin((m + 1)x_kπ / (Є ** 0.5)) sin((n + 1)y_kπ * (Є ** 0.5)))
+				| 0 <= k < K, 0 <= n < N, 0 <= m < M
+			}
+		*/
+
+		// handle errors
+		if (x.size() != y.size()) {
+			throw std::invalid_argument("x and y differ in size.");
+		}
+		const unsigned long K = x.size();
+		const double sqrt_epsilon = sqrt(epsilon);
+		T::Matrix_1D x_hat(K);
+		T::Matrix_1D y_hat(K);
+		for (unsigned long k = 0; k < K; k++) {
+			x_hat[k] = x[k] * pi / sqrt_epsilon;
+			y_hat[k] = y[k] * pi * sqrt_epsilon;
+		}
+		T::Matrix_1D S_x(M * K);
+		T::Matrix_1D S_y(N * K);
+		sineSeries(x_hat.data(), K, M, S_x.data());
+		sineSeries(y_hat.data(), K, N, S_y.data());
+		T::Matrix_1D m_hat(M);
+		for (unsigned long k = 0; k < K; k++) {
+			for (unsigned long m = 0; m < M; m++) { m_hat[m] = S_x[m * K + k]; }
+			for (unsigned long n = 0; n < N; n++) {
+				const double n_hat = S_y[n * K + k];
+				double* a = A + (k * N + n) * M;
+				for (unsigned long m = 0; m < M; m++) { a[m] = abs(m_hat[m] * n_hat); }
+			}
+		}
+	}
+
+	inline void rectangularChladniPattern(
+		const double& n, const double& m, T::BitImage& M, const double& tolerance = 0.1
+	) {
+		/*
+		Produce the 2D Chladni pattern for a rectangular plate, written directly into a packed
+		bit image of size M.X * M.Y. The pattern is the difference of two outer products, and so
+		the four cosine vectors are evaluated once, and each row is thresholded using NodalRow().
+		input:
+			n = nth modal index
+			m = mth modal index
+			M = the output image
+			tolerance = the standard deviation between the calculation and the final pattern
+		output:
+			M = {
+				cos(nπx/X) cos(mπy/Y) - cos(mπx/X) cos(nπy/Y) ≈ 0
+			}
+		*/
+
+		T::Matrix_1D x_n(M.X);
+		T::Matrix_1D x_m(M.X);
+		T::Matrix_1D y_n(M.Y);
+		T::Matrix_1D y_m(M.Y);
+		for (unsigned long x = 0; x < M.X; x++) {
+			x_n[x] = cos(n * pi * x / M.X);
+			x_m[x] = cos(m * pi * x / M.X);
+		}
+		for (unsigned long y = 0; y < M.Y; y++) {
+			y_n[y] = cos(n * pi * y / M.Y);
+			y_m[y] = cos(m * pi * y / M.Y);
+		}
+		const NodalRowKernel nodal_row = NodalRow();
+		for (unsigned long x = 0; x < M.X; x++) {
+			nodal_row(x_n[x], x_m[x], y_m.data(), y_n.data(), M.Y, tolerance, M.row(x));
+		}
+	}
+
 	inline T::BooleanImage rectangularChladniPattern(
 		const double& n,
 		const double& m,
@@ -71,17 +161,9 @@ namespace kac_core::physics {
 			}
 		*/
 
-		T::BooleanImage M(X, std::vector<short>(Y, 0));
-		for (unsigned long x = 0; x < X; x++) {
-			double x_m = cos(m * pi * x / X);
-			double x_n = cos(n * pi * x / X);
-			for (unsigned long y = 0; y < Y; y++) {
-				M[x][y] = abs((x_n * cos(m * pi * y / Y)) - (x_m * cos(n * pi * y / Y))) < tolerance
-							? 1
-							: 0;
-			}
-		}
-		return M;
+		T::BitImage M(X, Y);
+		rectangularChladniPattern(n, m, M, tolerance);
+		return M.matrix();
 	}
 
 	inline T::Matrix_2D
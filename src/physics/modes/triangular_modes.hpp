@@ -8,21 +8,52 @@ rectangular wave equation.
 // core
 #include <math.h>
 #include <numbers>
+#include <stdexcept>
 #include <vector>
 using namespace std::numbers;
 
 // src
 #include "../../types.hpp"
+#include "./sine_series.hpp"
 namespace T = kac_core::types;
 
 namespace kac_core::physics {
 
+	inline T::Matrix_1D
+	equilateralTriangleOrderAmplitudes(double u, double v, double w, const unsigned long& N) {
+		/*
+		Calculate the amplitudes of the equilateral triangle eigenmodes relative to a trilinear
+		strike location according to Lamé's formula. As every mode of an order shares the same
+		amplitude, a single amplitude is returned per order, which is broadcast across the modes
+		of that order, such as by pruneModes() and WaveEquationWaveform2D().
+		Seth (1940) Transverse Vibrations of Triangular Membranes.
+		input:
+			( u, v, w ) = trilinear coordinate
+			N = number of modal orders
+		output:
+			A = {
+				abs(sin(nuπ) sin(nvπ) sin(nwπ))
+				| a ∈ ℝ, 0 < n <= N
+			}
+		*/
+
+		u *= pi;
+		v *= pi;
+		w *= pi;
+		T::Matrix_1D A(N);
+		for (unsigned long n = 0; n < N; n++) {
+			A[n] = abs(sin((n + 1) * u) * sin((n + 1) * v) * sin((n + 1) * w));
+		}
+		return A;
+	}
+
 	inline T::Matrix_2D equilateralTriangleAmplitudes(
 		double u, double v, double w, const unsigned long& N, const unsigned long& M
 	) {
 		/*
 		Calculate the amplitudes of the equilateral triangle eigenmodes relative to a trilinear
-		strike location according to Lamé's formula.
+		strike location according to Lamé's formula. See equilateralTriangleOrderAmplitudes() for
+		a compact representation.
 		Seth (1940) Transverse Vibrations of Triangular Membranes.
 		input:
 			( u, v, w ) = trilinear coordinate
@@ -35,17 +66,57 @@ namespace kac_core::physics {
 			}
 		*/
 
-		u *= pi;
-		v *= pi;
-		w *= pi;
+		const T::Matrix_1D A_n = equilateralTriangleOrderAmplitudes(u, v, w, N);
 		T::Matrix_2D A(N, T::Matrix_1D(M, 0));
-		for (unsigned long n = 0; n < N; n++) {
-			double n_hat = abs(sin((n + 1) * u) * sin((n + 1) * v) * sin((n + 1) * w));
-			for (unsigned long m = 0; m < M; m++) { A[n][m] = n_hat; }
-		}
+		for (unsigned long n = 0; n < N; n++) { A[n].assign(M, A_n[n]); }
 		return A;
 	}
 
+	inline void equilateralTriangleAmplitudesBatch(
+		const T::Matrix_1D& u,
+		const T::Matrix_1D& v,
+		const T::Matrix_1D& w,
+		const unsigned long& N,
+		const unsigned long& M,
+		double* A
+	) {
+		/*
+		Calculate the amplitudes of the equilateral triangle eigenmodes relative to a batch of K
+		trilinear strike locations according to Lamé's formula. The harmonics of every strike are
+		evaluated at once, see sineSeries().
+		input:
+			( u, v, w ) = trilinear coordinates
+			N = number of modal orders
+			M = number of modes per order
+		output:
+			A[(k * N + n) * M + m] = abs(sin((n + 1)u_kπ) sin((n + 1)v_kπ) sin((n + 1)w_kπ))
+			| 0 <= k < K, 0 <= n < N, 0 <= m < M
+		*/
+
+		// handle errors
+		if (u.size() != v.size() || u.size() != w.size()) {
+			throw std::invalid_argument("u, v and w differ in size.");
+		}
+		const unsigned long K = u.size();
+		T::Matrix_1D theta(3 * K);
+		for (unsigned long k = 0; k < K; k++) {
+			theta[k] = u[k] * pi;
+			theta[K + k] = v[k] * pi;
+			theta[2 * K + k] = w[k] * pi;
+		}
+		// S[n * 3K + k] = sin((n + 1)u_kπ), S[n * 3K + K + k] = sin((n + 1)v_kπ), ...
+		T::Matrix_1D S(3 * K * N);
+		sineSeries(theta.data(), 3 * K, N, S.data());
+		for (unsigned long k = 0; k < K; k++) {
+			for (unsigned long n = 0; n < N; n++) {
+				const double* s = S.data() + n * 3 * K + k;
+				const double n_hat = abs(s[0] * s[K] * s[2 * K]);
+				double* a = A + (k * N + n) * M;
+				for (unsigned long m = 0; m < M; m++) { a[m] = n_hat; }
+			}
+		}
+	}
+
 	inline T::Matrix_2D equilateralTriangleSeries(const unsigned long& N, const unsigned long& M) {
 		/*
 		Calculate the eigenmodes of an equilateral triangle according to Lamé's formula.
@@ -5,7 +5,7 @@ Functions relating to the wave equation.
 #pragma once
 
 // core
-#include <algorithm>	// max
+#include <algorithm>	// max, min
 #include <math.h>
 #include <numbers>
 #include <vector>
@@ -13,52 +13,260 @@ using namespace std::numbers;
 
 // src
 #include "../../types.hpp"
+#include "../../utils/thread_pool.hpp"
+#include "./oscillator_bank.hpp"
 namespace T = kac_core::types;
+namespace U = kac_core::utils;
 
 namespace kac_core::physics {
 
-	inline T::Matrix_1D WaveEquationWaveform2D(
-		T::Matrix_2D F,
-		const T::Matrix_2D& A,
-		const double& d,
+	struct ModeList {
+		/*
+		A compact list of the modes of a 2D wave equation, as synthesised by an oscillator bank.
+		*/
+
+		// vars
+		T::Matrix_1D omega;		  // angular frequency of each mode, in radians per sample
+		T::Matrix_1D amplitude;	  // normalised amplitude of each mode
+	};
+
+	template <typename Scalar = double>
+	inline ModeList pruneModes(
+		const std::vector<std::vector<Scalar>>& F,
+		const std::vector<std::vector<Scalar>>& A,
 		const double& k,
-		const unsigned long& T
+		const double& threshold = 0.
 	) {
 		/*
-		Calculate a closed form solution to the 2D wave equation.
+		Compact the modes of a 2D wave equation, discarding those that are inaudible. Modes at or
+		above the nyquist frequency would alias, and are always discarded. The amplitudes of the
+		surviving modes are normalised by max(|A|) * NM, as though every mode were present.
 		input:
 			F = frequencies (hertz)
-			A = amplitudes ∈ [0, 1]
-			d = decay
+			A = amplitudes ∈ [-1, 1]
 			k = sample length
-			T = length of simulation
+			threshold = modes for which |A| <= threshold * max(|A|) are discarded.
 		output:
-			waveform = W[t] ∈ A * e^dt * sin(ωt) / max(A) * NM
+			modes = {
+				ω = 2πkF,
+				a = A / max(|A|) * NM,
+			} ∀ F < 1 / 2k, |A| > threshold * max(|A|)
 		*/
 
-		T::Matrix_1D waveform(T);
 		const unsigned long N = F.size();
 		const unsigned long M = F[0].size();
-		double A_max_NM = 0.;
+		double A_max = 0.;
 		for (unsigned long n = 0; n < N; n++) {
 			for (unsigned long m = 0; m < M; m++) {
-				// calculate A_max and transform F into ω
-				A_max_NM = std::max(A_max_NM, A[n][m]);
-				F[n][m] *= 2 * pi * k;
+				A_max = std::max(A_max, abs(double(A[n][m])));
 			}
 		}
-		A_max_NM *= N * M;
-		for (unsigned long t = 0; t < T; t++) {
-			double d_t = pow(e, t * d);
-			for (unsigned long n = 0; n < N; n++) {
-				for (unsigned long m = 0; m < M; m++) {
-					// 2009 - Bilbao, pp.65-66
-					// 2016 - Chaigne & Kergomard, p.154
-					waveform[t] += A[n][m] * d_t * sin(t * F[n][m]) / A_max_NM;
+		ModeList modes;
+		for (unsigned long n = 0; n < N; n++) {
+			for (unsigned long m = 0; m < M; m++) {
+				if (F[n][m] * k >= 0.5 || abs(double(A[n][m])) <= threshold * A_max) {
+					continue;
+				}
+				modes.omega.push_back(F[n][m] * (2 * pi * k));
+				modes.amplitude.push_back(A[n][m] / (A_max * N * M));
+			}
+		}
+		return modes;
+	}
+
+	template <typename Scalar = double>
+	inline ModeList pruneModes(
+		const std::vector<std::vector<Scalar>>& F,
+		const std::vector<Scalar>& A,
+		const double& k,
+		const double& threshold = 0.
+	) {
+		/*
+		Compact the modes of a 2D wave equation, where every mode of an order n shares the
+		amplitude A[n], such as those of equilateralTriangleOrderAmplitudes(). See above.
+		input:
+			F = frequencies (hertz)
+			A = amplitude of each order ∈ [-1, 1]
+			k = sample length
+			threshold = orders for which |A| <= threshold * max(|A|) are discarded.
+		output:
+			modes = {
+				ω = 2πkF,
+				a = A / max(|A|) * NM,
+			} ∀ F < 1 / 2k, |A| > threshold * max(|A|)
+		*/
+
+		const unsigned long N = F.size();
+		const unsigned long M = F[0].size();
+		double A_max = 0.;
+		for (unsigned long n = 0; n < N; n++) { A_max = std::max(A_max, abs(double(A[n]))); }
+		ModeList modes;
+		for (unsigned long n = 0; n < N; n++) {
+			if (abs(double(A[n])) <= threshold * A_max) {
+				continue;
+			}
+			const double a = A[n] / (A_max * N * M);
+			for (unsigned long m = 0; m < M; m++) {
+				if (F[n][m] * k < 0.5) {
+					modes.omega.push_back(F[n][m] * (2 * pi * k));
+					modes.amplitude.push_back(a);
 				}
 			}
 		}
+		return modes;
+	}
+
+	template <typename Scalar = double>
+	inline std::vector<Scalar> WaveEquationWaveform2D(
+		const ModeList& modes, const double& d, const unsigned long& T, const double& threshold = 0.
+	) {
+		/*
+		Calculate the solution to the 2D wave equation from a compact list of modes, using a
+		recursive oscillator bank. See ModalOscillatorBank for the tolerance relative to the
+		closed form.
+		input:
+			modes = the modes of the wave equation, see pruneModes().
+			d = decay
+			T = length of simulation
+			threshold = once the decay e^dt falls to the threshold, the remainder of the waveform
+				is silent.
+		output:
+			waveform = W[t] ∈ a * e^dt * sin(ωt)
+		*/
+
+		std::vector<Scalar> waveform(T, 0.);
+		unsigned long T_audible = T;
+		if (threshold > 0. && d < 0.) {
+			T_audible = std::min(T, static_cast<unsigned long>(ceil(log(threshold) / d)));
+		}
+		// 2009 - Bilbao, pp.65-66
+		// 2016 - Chaigne & Kergomard, p.154
+		ModalOscillatorBank(modes.omega, modes.amplitude, d).process(waveform.data(), T_audible);
 		return waveform;
 	}
 
+	template <typename Scalar = double>
+	inline std::vector<Scalar> WaveEquationWaveform2D(
+		const ModeList& modes,
+		const double& d,
+		const unsigned long& T,
+		const double& threshold,
+		U::ThreadPool& pool
+	) {
+		/*
+		Calculate the solution to the 2D wave equation from a compact list of modes, using one
+		recursive oscillator bank per thread. The time axis is divided into chunks, each of which
+		seeds its phasors from the closed form, such that the chunks are independent of one
+		another. Chunks are aligned to the reseeding interval of the oscillator bank, and so the
+		waveform is identical to that of the serial implementation.
+		input:
+			modes = the modes of the wave equation, see pruneModes().
+			d = decay
+			T = length of simulation
+			threshold = once the decay e^dt falls to the threshold, the remainder of the waveform
+				is silent.
+			pool = the threads across which the waveform is rendered.
+		output:
+			waveform = W[t] ∈ a * e^dt * sin(ωt)
+		*/
+
+		std::vector<Scalar> waveform(T, 0.);
+		unsigned long T_audible = T;
+		if (threshold > 0. && d < 0.) {
+			T_audible = std::min(T, static_cast<unsigned long>(ceil(log(threshold) / d)));
+		}
+		// divide the waveform into chunks of C samples, roughly four per thread
+		std::vector<ModalOscillatorBank> banks(
+			pool.size(), ModalOscillatorBank(modes.omega, modes.amplitude, d)
+		);
+		const unsigned long R = banks[0].interval();
+		const unsigned long C = std::max((T_audible / (4 * pool.size()) + R - 1) / R, 1ul) * R;
+		pool.schedule(
+			(T_audible + C - 1) / C,
+			[&banks, &waveform, &C, &T_audible](const unsigned long& c, const unsigned long& n) {
+				banks[n].seed(c * C);
+				banks[n].process(waveform.data() + c * C, std::min(C, T_audible - c * C));
+			}
+		);
+		return waveform;
+	}
+
+	template <typename Scalar = double>
+	inline std::vector<Scalar> WaveEquationWaveform2D(
+		const std::vector<std::vector<Scalar>>& F,
+		const std::vector<std::vector<Scalar>>& A,
+		const double& d,
+		const double& k,
+		const unsigned long& T,
+		const double& amplitude_threshold = 0.,
+		const double& decay_threshold = 0.
+	) {
+		/*
+		Calculate the solution to the 2D wave equation, using a recursive oscillator bank in place
+		of evaluating the closed form at every sample. Modes at or above the nyquist frequency,
+		modes below the amplitude threshold, and samples below the decay threshold, are discarded
+		before synthesis. The phase and decay
+		of each mode are evaluated in double precision regardless of the scalar type, as t * ω
+		quickly exceeds the precision of a float. See ModalOscillatorBank for the tolerance
+		relative to the closed form.
+		input:
+			F = frequencies (hertz)
+			A = amplitudes ∈ [-1, 1]
+			d = decay
+			k = sample length
+			T = length of simulation
+			amplitude_threshold = relative amplitude below which modes are discarded, see
+				pruneModes().
+			decay_threshold = decay below which samples are discarded, see
+				WaveEquationWaveform2D(modes, d, T, threshold).
+		output:
+			waveform = W[t] ∈ A * e^dt * sin(ωt) / max(|A|) * NM
+		*/
+
+		return WaveEquationWaveform2D<Scalar>(
+			pruneModes(F, A, k, amplitude_threshold), d, T, decay_threshold
+		);
+	}
+
+	template <typename Scalar = double>
+	inline std::vector<Scalar> WaveEquationWaveform2D(
+		const std::vector<std::vector<Scalar>>& F,
+		const std::vector<Scalar>& A,
+		const double& d,
+		const double& k,
+		const unsigned long& T,
+		const double& amplitude_threshold = 0.,
+		const double& decay_threshold = 0.
+	) {
+		/*
+		Calculate the solution to the 2D wave equation, where every mode of an order n shares the
+		amplitude A[n], such as those of equilateralTriangleOrderAmplitudes(). See above.
+		*/
+
+		return WaveEquationWaveform2D<Scalar>(
+			pruneModes(F, A, k, amplitude_threshold), d, T, decay_threshold
+		);
+	}
+
+	template <typename Scalar = double>
+	inline std::vector<Scalar> WaveEquationWaveform2D(
+		const std::vector<std::vector<Scalar>>& F,
+		const std::vector<std::vector<Scalar>>& A,
+		const double& d,
+		const double& k,
+		const unsigned long& T,
+		const double& amplitude_threshold,
+		const double& decay_threshold,
+		U::ThreadPool& pool
+	) {
+		/*
+		Calculate the solution to the 2D wave equation, rendering chunks of the waveform in
+		parallel. See above.
+		*/
+
+		return WaveEquationWaveform2D<Scalar>(
+			pruneModes(F, A, k, amplitude_threshold), d, T, decay_threshold, pool
+		);
+	}
+
 }
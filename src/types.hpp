@@ -5,6 +5,10 @@
 #pragma once
 
 // core
+#include <algorithm>	// copy, min
+#include <bit>			// countr_zero, popcount
+#include <climits>		// ULONG_MAX
+#include <cstdint>
 #include <math.h>
 #include <vector>
 
@@ -15,6 +19,85 @@ namespace kac_core::types {
 	typedef std::vector<std::vector<double>> Matrix_2D;
 	typedef std::vector<std::vector<short>> BooleanImage;
 
+	template <typename V>
+	struct GridView {
+		/*
+		A non-owning, row-major view of a 2 dimensional grid, in the style of std::mdspan. The
+		element (x, y) is found at data[x * stride + y], such that each row x is contiguous in
+		memory.
+		*/
+
+		// vars
+		V* data = nullptr;
+		unsigned long X = 0;
+		unsigned long Y = 0;
+		unsigned long stride = 0;
+
+		// constructors
+		GridView() {};
+		GridView(V* data, unsigned long X, unsigned long Y, unsigned long stride):
+			data(data), X(X), Y(Y), stride(stride) {};
+
+		// methods
+		V& operator()(unsigned long x, unsigned long y) const { return data[x * stride + y]; }
+		V* row(unsigned long x) const { return data + x * stride; }
+		operator GridView<const V>() const { return GridView<const V>(data, X, Y, stride); }
+	};
+
+	template <typename V>
+	struct Grid {
+		/*
+		A contiguous, row-major 2 dimensional grid. Each row is padded such that the stride is a
+		multiple of 64 bytes, so that every row begins at the same offset within a cache line. The
+		storage itself is not aligned to 64 bytes, and so a row may still straddle cache lines.
+		*/
+
+		// vars
+		unsigned long X = 0;
+		unsigned long Y = 0;
+		unsigned long stride = 0;
+		std::vector<V> data;
+
+		// constructors
+		Grid() {};
+		Grid(unsigned long X, unsigned long Y, const V& value = V()):
+			X(X), Y(Y), stride(padStride(Y)), data(X * padStride(Y), value) {};
+		Grid(const std::vector<std::vector<V>>& M):
+			Grid(M.size(), M.size() > 0 ? M[0].size() : 0) {
+			for (unsigned long x = 0; x < X; x++) {
+				std::copy(M[x].begin(), M[x].begin() + Y, row(x));
+			}
+		};
+
+		// methods
+		V& operator()(unsigned long x, unsigned long y) { return data[x * stride + y]; }
+		const V& operator()(unsigned long x, unsigned long y) const {
+			return data[x * stride + y];
+		}
+		V* row(unsigned long x) { return data.data() + x * stride; }
+		const V* row(unsigned long x) const { return data.data() + x * stride; }
+		GridView<V> view() { return GridView<V>(data.data(), X, Y, stride); }
+		GridView<const V> view() const { return GridView<const V>(data.data(), X, Y, stride); }
+		operator GridView<const V>() const { return view(); }
+		std::vector<std::vector<V>> matrix() const {
+			/*
+			Copy the grid into a vector of vectors.
+			*/
+
+			std::vector<std::vector<V>> M(X);
+			for (unsigned long x = 0; x < X; x++) { M[x].assign(row(x), row(x) + Y); }
+			return M;
+		}
+		static unsigned long padStride(unsigned long Y) {
+			/*
+			Round the length of a row up to a multiple of 64 bytes.
+			*/
+
+			const unsigned long L = sizeof(V) < 64 ? 64 / sizeof(V) : 1;
+			return ((Y + L - 1) / L) * L;
+		}
+	};
+
 	typedef struct Point {
 		/*
 		A point on the Euclidean plane.
@@ -58,4 +141,147 @@ namespace kac_core::types {
 	// A polygon defined on the Euclidean plane.
 	typedef std::vector<Point> Polygon;
 
+	typedef struct Span {
+		/*
+		A run of consecutive cells [y_0, y_1) along row x of a grid.
+		*/
+
+		// vars
+		unsigned long x = 0;
+		unsigned long y_0 = 0;
+		unsigned long y_1 = 0;
+
+		// constructors
+		Span() {};
+		Span(unsigned long x, unsigned long y_0, unsigned long y_1): x(x), y_0(y_0), y_1(y_1) {};
+	} Span;
+
+	struct BitImage {
+		/*
+		A packed boolean image, storing 64 pixels per word. The pixel (x, y) is bit y % 64 of
+		the word data[x * stride + y / 64], such that each row x is a contiguous run of words.
+		Bits beyond Y at the end of each row are always 0.
+		*/
+
+		// vars
+		unsigned long X = 0;
+		unsigned long Y = 0;
+		unsigned long stride = 0;
+		std::vector<std::uint64_t> data;
+
+		// constructors
+		BitImage() {};
+		BitImage(unsigned long X, unsigned long Y):
+			X(X), Y(Y), stride((Y + 63) / 64), data(X * ((Y + 63) / 64), 0) {};
+		BitImage(const BooleanImage& M): BitImage(M.size(), M.size() > 0 ? M[0].size() : 0) {
+			for (unsigned long x = 0; x < X; x++) {
+				for (unsigned long y = 0; y < Y; y++) {
+					if (M[x][y] != 0) {
+						set(x, y);
+					}
+				}
+			}
+		};
+
+		// methods
+		bool operator()(unsigned long x, unsigned long y) const {
+			return (data[x * stride + y / 64] >> (y % 64)) & 1;
+		}
+		void set(unsigned long x, unsigned long y, bool value = true) {
+			const std::uint64_t bit = std::uint64_t(1) << (y % 64);
+			std::uint64_t& word = data[x * stride + y / 64];
+			word = value ? word | bit : word & ~bit;
+		}
+		void setSpan(unsigned long x, unsigned long y_0, unsigned long y_1) {
+			/*
+			Set the pixels [y_0, y_1) of row x, a word at a time.
+			*/
+
+			std::uint64_t* r = row(x);
+			while (y_0 < y_1) {
+				const unsigned long n = std::min(64 - y_0 % 64, y_1 - y_0);
+				const std::uint64_t ones = ~std::uint64_t(0) >> (64 - n);
+				r[y_0 / 64] |= ones << (y_0 % 64);
+				y_0 += n;
+			}
+		}
+		std::uint64_t* row(unsigned long x) { return data.data() + x * stride; }
+		const std::uint64_t* row(unsigned long x) const { return data.data() + x * stride; }
+		unsigned long count() const {
+			/*
+			The number of set pixels.
+			*/
+
+			unsigned long n = 0;
+			for (const std::uint64_t& word: data) { n += std::popcount(word); }
+			return n;
+		}
+		unsigned long count(unsigned long x) const {
+			/*
+			The number of set pixels in row x.
+			*/
+
+			unsigned long n = 0;
+			for (unsigned long i = 0; i < stride; i++) { n += std::popcount(row(x)[i]); }
+			return n;
+		}
+		void rowSpans(
+			unsigned long x,
+			std::vector<Span>& S,
+			unsigned long y_0 = 0,
+			unsigned long y_1 = ULONG_MAX
+		) const {
+			/*
+			Append the runs of set pixels along row x, clipped to [y_0, min(y_1, Y)), to S. Runs
+			are found a word at a time, by counting the trailing zeros of each word.
+			*/
+
+			y_1 = std::min(y_1, Y);
+			const std::uint64_t* r = row(x);
+			for (unsigned long y = find(r, y_0, y_1, true); y < y_1; y = find(r, y, y_1, true)) {
+				const unsigned long y_start = y;
+				y = find(r, y, y_1, false);
+				S.emplace_back(x, y_start, y);
+			}
+		}
+		std::vector<Span> spans() const {
+			/*
+			The runs of set pixels, ordered by row and then by column.
+			*/
+
+			std::vector<Span> S;
+			for (unsigned long x = 0; x < X; x++) { rowSpans(x, S); }
+			return S;
+		}
+		BooleanImage matrix() const {
+			/*
+			Unpack the image into a vector of vectors.
+			*/
+
+			BooleanImage M(X, std::vector<short>(Y, 0));
+			for (unsigned long x = 0; x < X; x++) {
+				for (unsigned long y = 0; y < Y; y++) { M[x][y] = (*this)(x, y) ? 1 : 0; }
+			}
+			return M;
+		}
+
+	private:
+		static unsigned long find(
+			const std::uint64_t* r, unsigned long y, const unsigned long& y_1, const bool& value
+		) {
+			/*
+			The first pixel in [y, y_1) of the row r equal to value, or y_1 if there is none.
+			*/
+
+			while (y < y_1) {
+				const std::uint64_t word = (value ? r[y / 64] : ~r[y / 64]) >> (y % 64);
+				if (word != 0) {
+					return std::min(y + std::countr_zero(word), y_1);
+				}
+				y = (y / 64 + 1) * 64;
+			}
+			return y_1;
+		}
+	};
+
 }
@@ -0,0 +1,8 @@
+/*
+Central import for all files in /utils.
+*/
+
+#pragma once
+
+#include "simd.hpp"
+#include "thread_pool.hpp"
@@ -0,0 +1,46 @@
+/*
+Utilities for selecting vectorised code paths at runtime.
+*/
+
+#pragma once
+
+// x86 intrinsics are only used with compilers that support per function target attributes.
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+	#define KAC_CORE_X86_SIMD
+	#include <immintrin.h>
+#endif
+
+// Floating point contraction (fusing a * b + c into a single instruction) changes rounding, and
+// is disabled inside of kernels which promise identical results across instruction sets.
+#if defined(__clang__)
+	#define KAC_CORE_NO_CONTRACT
+	#define KAC_CORE_FP_CONTRACT_OFF _Pragma("clang fp contract(off)")
+#elif defined(__GNUC__)
+	#define KAC_CORE_NO_CONTRACT __attribute__((optimize("fp-contract=off")))
+	#define KAC_CORE_FP_CONTRACT_OFF
+#else
+	#define KAC_CORE_NO_CONTRACT
+	#define KAC_CORE_FP_CONTRACT_OFF
+#endif
+
+namespace kac_core::utils {
+
+	enum class SIMDLevel { Scalar, AVX2, AVX512 };
+
+	inline SIMDLevel detectSIMDLevel() {
+		/*
+		Determine the widest instruction set supported by the current processor. The result is
+		computed once and cached for the lifetime of the process.
+		*/
+
+#ifdef KAC_CORE_X86_SIMD
+		static const SIMDLevel level = __builtin_cpu_supports("avx512f") ? SIMDLevel::AVX512
+									 : __builtin_cpu_supports("avx2")	 ? SIMDLevel::AVX2
+																		 : SIMDLevel::Scalar;
+		return level;
+#else
+		return SIMDLevel::Scalar;
+#endif
+	}
+
+}
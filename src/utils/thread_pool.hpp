@@ -0,0 +1,206 @@
+/*
+A persistent pool of worker threads.
+*/
+
+#pragma once
+
+// core
+#include <algorithm>	// max
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace kac_core::utils {
+
+	class ThreadPool {
+		/*
+		A persistent team of threads. Each call to run() executes a task once on every thread of
+		the pool concurrently, with the calling thread acting as thread 0, and returns when every
+		thread has finished. As each task is guaranteed its own thread, the tasks may synchronise
+		with one another, such as by using a std::barrier. Calls to run() from separate threads
+		are serialised, and run() must not be called from within a task.
+		*/
+
+	public:
+		// constructors
+		ThreadPool(const unsigned long& N = std::thread::hardware_concurrency()) {
+			for (unsigned long n = 1; n < std::max(N, 1ul); n++) {
+				workers.emplace_back([this, n]() { work(n); });
+			}
+		}
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+
+		// destructors
+		~ThreadPool() {
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				stop = true;
+			}
+			start_cv.notify_all();
+			for (std::thread& worker: workers) { worker.join(); }
+		}
+
+		// methods
+		unsigned long size() const {
+			/*
+			The number of threads in the pool, including the calling thread.
+			*/
+
+			return workers.size() + 1;
+		}
+
+		void run(const std::function<void(unsigned long)>& f) {
+			/*
+			Execute f(n) for every n ∈ [0, size()) concurrently, and rethrow the first exception
+			thrown by any of the tasks.
+			*/
+
+			std::lock_guard<std::mutex> run_lock(run_mutex);
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				task = &f;
+				running = workers.size();
+				error = nullptr;
+				generation++;
+			}
+			start_cv.notify_all();
+			try {
+				f(0);
+			} catch (...) {
+				std::lock_guard<std::mutex> lock(mutex);
+				error = error ? error : std::current_exception();
+			}
+			std::unique_lock<std::mutex> lock(mutex);
+			done_cv.wait(lock, [this]() { return running == 0; });
+			if (error) {
+				std::rethrow_exception(error);
+			}
+		}
+
+		void schedule(
+			const unsigned long& N, const std::function<void(unsigned long, unsigned long)>& f
+		) {
+			/*
+			Execute f(i, n) for every task i ∈ [0, N), where n is the thread executing the task.
+			Tasks are initially divided into one contiguous range per thread. A thread that
+			exhausts its own range steals the back half of the largest remaining range, such that
+			tasks of uneven cost are balanced across the pool. The first exception thrown by any
+			of the tasks is rethrown.
+			*/
+
+			struct Range {
+				std::mutex mutex;
+				unsigned long begin = 0;
+				unsigned long end = 0;
+			};
+			std::vector<Range> ranges(size());
+			for (unsigned long n = 0; n < ranges.size(); n++) {
+				ranges[n].begin = N * n / ranges.size();
+				ranges[n].end = N * (n + 1) / ranges.size();
+			}
+			run([&ranges, &f](const unsigned long& n) {
+				Range& own = ranges[n];
+				while (true) {
+					// take the next task from the front of this thread's range
+					unsigned long i = 0;
+					bool found = false;
+					{
+						std::lock_guard<std::mutex> lock(own.mutex);
+						if (own.begin < own.end) {
+							i = own.begin++;
+							found = true;
+						}
+					}
+					if (found) {
+						f(i, n);
+						continue;
+					}
+					// otherwise steal the back half of the largest range
+					unsigned long victim = n;
+					unsigned long remaining = 0;
+					for (unsigned long m = 0; m < ranges.size(); m++) {
+						std::lock_guard<std::mutex> lock(ranges[m].mutex);
+						if (ranges[m].end - ranges[m].begin > remaining) {
+							remaining = ranges[m].end - ranges[m].begin;
+							victim = m;
+						}
+					}
+					if (remaining == 0) {
+						return;
+					}
+					unsigned long begin = 0;
+					unsigned long end = 0;
+					{
+						std::lock_guard<std::mutex> lock(ranges[victim].mutex);
+						end = ranges[victim].end;
+						begin = std::max(
+							ranges[victim].begin, end - (end - ranges[victim].begin + 1) / 2
+						);
+						ranges[victim].end = begin;
+					}
+					std::lock_guard<std::mutex> lock(own.mutex);
+					own.begin = begin;
+					own.end = end;
+				}
+			});
+		}
+
+	private:
+		// vars
+		std::vector<std::thread> workers;
+		std::mutex mutex;
+		std::mutex run_mutex;
+		std::condition_variable start_cv;
+		std::condition_variable done_cv;
+		const std::function<void(unsigned long)>* task = nullptr;
+		std::exception_ptr error = nullptr;
+		unsigned long generation = 0;
+		unsigned long running = 0;
+		bool stop = false;
+
+		// methods
+		void work(const unsigned long& n) {
+			/*
+			Worker loop, waiting for each new generation of tasks.
+			*/
+
+			unsigned long seen = 0;
+			while (true) {
+				const std::function<void(unsigned long)>* f;
+				{
+					std::unique_lock<std::mutex> lock(mutex);
+					start_cv.wait(lock, [this, &seen]() { return stop || generation != seen; });
+					if (stop) {
+						return;
+					}
+					seen = generation;
+					f = task;
+				}
+				try {
+					(*f)(n);
+				} catch (...) {
+					std::lock_guard<std::mutex> lock(mutex);
+					error = error ? error : std::current_exception();
+				}
+				std::lock_guard<std::mutex> lock(mutex);
+				if (--running == 0) {
+					done_cv.notify_one();
+				}
+			}
+		}
+	};
+
+	inline ThreadPool& defaultThreadPool() {
+		/*
+		A process wide thread pool, with one thread per hardware thread.
+		*/
+
+		static ThreadPool pool;
+		return pool;
+	}
+
+}
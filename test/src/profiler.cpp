@@ -73,10 +73,26 @@ int main() {
 		Timer timer("  isPointInsidePolygon");
 		g::isPointInsidePolygon(centroid, P);
 	}
+	// store the results of isSimple, so that the brute force is not optimised away
+	volatile bool simple;
 	{
 		Timer timer("  isSimple");
-		g::isSimple(P);
+		simple = g::isSimple(P);
 	}
+	{
+		Timer timer("  isSimpleBruteForce");
+		simple = g::isSimpleBruteForce(P);
+	}
+	T::Polygon P_star = g::generateIrregularStar(20 * N);
+	{
+		Timer timer("  isSimple (" + std::to_string(20 * N) + " vertices)");
+		simple = g::isSimple(P_star);
+	}
+	{
+		Timer timer("  isSimpleBruteForce (" + std::to_string(20 * N) + " vertices)");
+		simple = g::isSimpleBruteForce(P_star);
+	}
+	(void)simple;
 	{
 		Timer timer("  largestVector");
 		g::largestVector(P);
@@ -5,6 +5,7 @@ Tests for /fdtd.
 // src
 #include <kac_core.hpp>
 namespace p = kac_core::physics;
+namespace U = kac_core::utils;
 
 // test
 #include "./utils.hpp"
@@ -42,5 +43,428 @@ int main() {
 		T::Point(0.5, 0.5)
 	);
 
+	/*
+	Test that a contiguous grid produces identical results to the vector of vectors.
+	*/
+	const unsigned long H = 24;
+	T::BooleanImage B(H, std::vector<short>(H, 0));
+	for (unsigned long x = 1; x < H - 1; x++) {
+		for (unsigned long y = 1; y < H - 1; y++) {
+			B[x][y] = pow(x - H / 2., 2) + pow(y - H / 2., 2) < pow(H / 2. - 2, 2) ? 1 : 0;
+		}
+	}
+	T::Matrix_2D u_0(H, T::Matrix_1D(H, 0.));
+	T::Matrix_2D u_1 = p::raisedCosine2D(H, H, T::Point(9., 13.), 4.);
+	T::Matrix_1D waveform =
+		p::FDTDWaveform2D(u_0, u_1, B, cfl_2, 2 - 4 * cfl_2, 1., 100, T::Point(0.4, 0.6));
+	T::Matrix_1D waveform_grid = p::FDTDWaveform2D(
+		T::Grid<double>(u_0),
+		T::Grid<double>(u_1),
+		T::Grid<short>(B),
+		cfl_2,
+		2 - 4 * cfl_2,
+		1.,
+		100,
+		T::Point(0.4, 0.6)
+	);
+	batchBooleanTest(
+		"FDTDWaveform2D is identical for T::Grid and T::Matrix_2D",
+		100,
+		[&waveform, &waveform_grid](const unsigned long& t) {
+			return waveform[t] == waveform_grid[t];
+		}
+	);
+
+	/*
+	Test that the FDTD simulation operates in place on caller owned grids.
+	*/
+	T::Grid<double> u_0_grid(u_0);
+	T::Grid<double> u_1_grid(u_1);
+	T::Matrix_1D waveform_view = p::FDTDWaveform2D(
+		u_0_grid.view(),
+		u_1_grid.view(),
+		T::Grid<short>(B).view(),
+		cfl_2,
+		2 - 4 * cfl_2,
+		1.,
+		100,
+		T::Point(0.4, 0.6)
+	);
+	batchBooleanTest(
+		"FDTDWaveform2D is identical when operating on views",
+		100,
+		[&waveform, &waveform_view](const unsigned long& t) {
+			return waveform[t] == waveform_view[t];
+		}
+	);
+	booleanTest(
+		"FDTDWaveform2D updates views in place",
+		p::FDTDReadPoint(T::Point(0.4, 0.6), H, H)(u_1_grid) == waveform[99]
+	);
+	T::Matrix_2D u_update = u_1;
+	booleanTest(
+		"FDTDUpdate2D returns by reference",
+		&p::FDTDUpdate2D(
+			u_update, u_0, B, cfl_2, 2 - 4 * cfl_2, 1., {1ul, H - 2}, {1ul, H - 2}
+		) == &u_update
+	);
+
+	/*
+	Test that the multithreaded FDTD simulation produces identical results.
+	*/
+	U::ThreadPool pool(4);
+	T::Matrix_1D waveform_parallel = p::FDTDWaveform2D(
+		T::Grid<double>(u_0),
+		T::Grid<double>(u_1),
+		T::Grid<short>(B),
+		cfl_2,
+		2 - 4 * cfl_2,
+		1.,
+		100,
+		T::Point(0.4, 0.6),
+		pool
+	);
+	batchBooleanTest(
+		"FDTDWaveform2D is identical when multithreaded",
+		100,
+		[&waveform, &waveform_parallel](const unsigned long& t) {
+			return waveform[t] == waveform_parallel[t];
+		}
+	);
+
+	/*
+	Test that the temporally blocked FDTD simulation produces identical results.
+	*/
+	T::Matrix_1D waveform_tiled = p::FDTDWaveform2D(
+		T::Grid<double>(u_0),
+		T::Grid<double>(u_1),
+		T::Grid<short>(B),
+		cfl_2,
+		2 - 4 * cfl_2,
+		1.,
+		100,
+		T::Point(0.4, 0.6),
+		p::FDTDTiling(5, 7)
+	);
+	batchBooleanTest(
+		"FDTDWaveform2D is identical when temporally blocked",
+		100,
+		[&waveform, &waveform_tiled](const unsigned long& t) {
+			return waveform[t] == waveform_tiled[t];
+		}
+	);
+	p::FDTDTiling tiling_unclamped;
+	tiling_unclamped.steps = 0;
+	booleanTest(
+		"FDTDWaveform2D treats a tile of 0 time steps as 1",
+		p::FDTDWaveform2D(
+			T::Grid<double>(u_0),
+			T::Grid<double>(u_1),
+			T::Grid<short>(B),
+			cfl_2,
+			2 - 4 * cfl_2,
+			1.,
+			100,
+			T::Point(0.4, 0.6),
+			tiling_unclamped
+		) == waveform
+	);
+
+	/*
+	Test that the FDTD simulation over active spans produces identical results.
+	*/
+	T::Matrix_1D waveform_spans = p::FDTDWaveform2D(
+		T::Grid<double>(u_0),
+		T::Grid<double>(u_1),
+		p::FDTDActiveSpans(T::Grid<short>(B)),
+		cfl_2,
+		2 - 4 * cfl_2,
+		1.,
+		100,
+		T::Point(0.4, 0.6)
+	);
+	batchBooleanTest(
+		"FDTDWaveform2D is identical when using active spans",
+		100,
+		[&waveform, &waveform_spans](const unsigned long& t) {
+			return waveform[t] == waveform_spans[t];
+		}
+	);
+
+	/*
+	Test that packed boundary conditions produce identical results.
+	*/
+	const T::BitImage B_packed(B);
+	const std::vector<T::Span> S_grid = p::FDTDActiveSpans(T::Grid<short>(B));
+	const std::vector<T::Span> S_packed = p::FDTDActiveSpans(B_packed);
+	unsigned long B_count = 0;
+	for (unsigned long x = 0; x < H; x++) {
+		for (unsigned long y = 0; y < H; y++) { B_count += B[x][y]; }
+	}
+	booleanTest(
+		"T::BitImage preserves the boundary conditions",
+		B_packed.matrix() == B && B_packed.count() == B_count
+	);
+	booleanTest(
+		"FDTDActiveSpans is identical for T::BitImage",
+		std::equal(
+			S_grid.begin(),
+			S_grid.end(),
+			S_packed.begin(),
+			S_packed.end(),
+			[](const T::Span& a, const T::Span& b) {
+				return a.x == b.x && a.y_0 == b.y_0 && a.y_1 == b.y_1;
+			}
+		)
+	);
+	T::Matrix_1D waveform_packed = p::FDTDWaveform2D(
+		T::Grid<double>(u_0),
+		T::Grid<double>(u_1),
+		B_packed,
+		cfl_2,
+		2 - 4 * cfl_2,
+		1.,
+		100,
+		T::Point(0.4, 0.6)
+	);
+	booleanTest("FDTDWaveform2D is identical for T::BitImage", waveform_packed == waveform);
+	T::BitImage runs(3, 300);
+	for (unsigned long y = 0; y < 300; y++) {
+		runs.set(1, y, (y / 7) % 3 != 0 || (y >= 60 && y < 200));
+		runs.set(2, y, y >= 64);
+	}
+	std::vector<T::Span> S_runs;
+	runs.rowSpans(1, S_runs, 5, 290);
+	bool runs_match = runs.count(0) == 0 && runs.count(2) == 236 && runs.spans().back().y_0 == 64;
+	for (unsigned long y = 5, i = 0; y < 290; y++) {
+		const bool inside = i < S_runs.size() && S_runs[i].y_0 <= y && y < S_runs[i].y_1;
+		runs_match = runs_match && inside == runs(1, y);
+		i += i < S_runs.size() && y + 1 == S_runs[i].y_1;
+	}
+	booleanTest("T::BitImage finds the runs of each row", runs_match);
+
+	/*
+	Test that streaming the FDTD simulation in blocks produces identical results.
+	*/
+	p::FDTDSimulator<double> simulator(
+		T::Grid<double>(u_0),
+		T::Grid<double>(u_1),
+		T::Grid<short>(B),
+		cfl_2,
+		2 - 4 * cfl_2,
+		1.,
+		T::Point(0.4, 0.6)
+	);
+	std::vector<float> waveform_stream(100);
+	for (unsigned long t = 0, n = 1; t < 100; t += n, n = 2 * n + 1) {
+		simulator.process(waveform_stream.data() + t, std::min(n, 100 - t));
+	}
+	batchBooleanTest(
+		"FDTDSimulator is identical when streamed in blocks",
+		100,
+		[&waveform, &waveform_stream](const unsigned long& t) {
+			return static_cast<float>(waveform[t]) == waveform_stream[t];
+		}
+	);
+
+	booleanTest("FDTDSimulator rejects boundary conditions larger than the grid", [&]() {
+		try {
+			p::FDTDSimulator<double> simulator_mismatched(
+				T::Grid<double>(u_0),
+				T::Grid<double>(u_1),
+				T::Grid<short>(H + 2, H + 2, 1),
+				cfl_2,
+				2 - 4 * cfl_2,
+				1.,
+				T::Point(0.4, 0.6)
+			);
+		} catch (const std::invalid_argument& e) {
+			return std::string(e.what()) == "u_0 and B differ in size.";
+		}
+		return false;
+	}());
+
+	/*
+	Test that sampling multiple read points produces identical results to separate simulations.
+	*/
+	std::vector<T::Matrix_1D> waveforms = p::FDTDWaveform2D(
+		T::Grid<double>(u_0),
+		T::Grid<double>(u_1),
+		T::Grid<short>(B),
+		cfl_2,
+		2 - 4 * cfl_2,
+		1.,
+		100,
+		std::vector<T::Point>({T::Point(0.4, 0.6), T::Point(0.7, 0.2)})
+	);
+	T::Matrix_1D waveform_other =
+		p::FDTDWaveform2D(u_0, u_1, B, cfl_2, 2 - 4 * cfl_2, 1., 100, T::Point(0.7, 0.2));
+	batchBooleanTest(
+		"FDTDWaveform2D is identical when sampling multiple read points",
+		100,
+		[&waveform, &waveform_other, &waveforms](const unsigned long& t) {
+			return waveforms[0][t] == waveform[t] && waveforms[1][t] == waveform_other[t];
+		}
+	);
+	p::FDTDSimulator<double> simulator_stereo(
+		T::Grid<double>(u_0),
+		T::Grid<double>(u_1),
+		T::Grid<short>(B),
+		cfl_2,
+		2 - 4 * cfl_2,
+		1.,
+		std::vector<T::Point>({T::Point(0.4, 0.6), T::Point(0.7, 0.2)})
+	);
+	p::FDTDSimulator<double> simulator_packed(
+		T::Grid<double>(u_0),
+		T::Grid<double>(u_1),
+		B_packed,
+		cfl_2,
+		2 - 4 * cfl_2,
+		1.,
+		std::vector<T::Point>({T::Point(0.4, 0.6), T::Point(0.7, 0.2)})
+	);
+	std::vector<float> waveform_interleaved(200);
+	std::vector<float> waveform_interleaved_packed(200);
+	simulator_packed.process(waveform_interleaved_packed.data(), 100);
+	simulator_stereo.process(waveform_interleaved.data(), 37);
+	simulator_stereo.process(waveform_interleaved.data() + 74, 63);
+	batchBooleanTest(
+		"FDTDSimulator interleaves multiple read points",
+		100,
+		[&waveform, &waveform_other, &waveform_interleaved](const unsigned long& t) {
+			return waveform_interleaved[2 * t] == static_cast<float>(waveform[t])
+				&& waveform_interleaved[2 * t + 1] == static_cast<float>(waveform_other[t]);
+		}
+	);
+	booleanTest(
+		"FDTDSimulator is identical for T::BitImage",
+		waveform_interleaved_packed == waveform_interleaved
+	);
+
+	/*
+	Test that a batch of FDTD simulations produces identical results to separate simulations.
+	*/
+	std::vector<p::FDTDJob<double>> jobs;
+	for (unsigned long i = 0; i < 9; i++) {
+		const unsigned long H_i = 8 + 3 * i;
+		T::Grid<short> B_i(H_i, H_i, 0);
+		for (unsigned long x = 1; x < H_i - 1; x++) {
+			for (unsigned long y = 1; y < H_i - 1; y++) { B_i(x, y) = (x + y) % 5 != 0 ? 1 : 0; }
+		}
+		jobs.emplace_back(
+			T::Grid<double>(H_i, H_i, 0.),
+			T::Grid<double>(p::raisedCosine2D(H_i, H_i, T::Point(H_i / 2., H_i / 3.), 3.)),
+			B_i,
+			cfl_2,
+			2 - 4 * cfl_2,
+			1.,
+			20 + 10 * i,
+			std::vector<T::Point>({T::Point(0.4, 0.6)})
+		);
+	}
+	p::FDTDBatch<double> batch(pool);
+	p::FDTDBatchResult<double> batch_result = batch(jobs);
+	batch_result = batch(jobs);
+	batchBooleanTest(
+		"FDTDBatch is identical to FDTDWaveform2D",
+		jobs.size(),
+		[&jobs, &batch_result](const unsigned long& i) {
+			return batch_result.waveforms[i][0]
+				== p::FDTDWaveform2D(
+					   jobs[i].u_0,
+					   jobs[i].u_1,
+					   jobs[i].B,
+					   jobs[i].c_0,
+					   jobs[i].c_1,
+					   jobs[i].c_2,
+					   jobs[i].length,
+					   jobs[i].W[0]
+				);
+		}
+	);
+	booleanTest(
+		"FDTDBatch reports its throughput",
+		batch_result.simulations_per_second > 0.
+	);
+
+	/*
+	Test that the single precision FDTD simulation is within its documented error bound.
+	*/
+	T::Matrix_1D waveform_decay = p::FDTDWaveform2D(
+		T::Grid<double>(u_0),
+		T::Grid<double>(u_1),
+		T::Grid<short>(B),
+		cfl_2,
+		2 - 4 * cfl_2,
+		0.9999,
+		1000,
+		T::Point(0.4, 0.6)
+	);
+	std::vector<float> waveform_float = p::FDTDWaveform2D(
+		T::Grid<float>(H, H, 0.f),
+		T::Grid<float>(p::raisedCosine2D<float>(H, H, T::Point(9., 13.), 4.)),
+		T::Grid<short>(B),
+		cfl_2,
+		2 - 4 * cfl_2,
+		0.9999,
+		1000,
+		T::Point(0.4, 0.6)
+	);
+	double waveform_max = 0.;
+	for (const double& w: waveform_decay) { waveform_max = std::max(waveform_max, abs(w)); }
+	batchBooleanTest(
+		"FDTDWaveform2D<float> is accurate relative to FDTDWaveform2D<double>",
+		1000,
+		[&waveform_decay, &waveform_float, &waveform_max](const unsigned long& t) {
+			return abs(waveform_float[t] - waveform_decay[t])
+				<= 4. * std::max(t, 1ul) * pow(2., -24.) * waveform_max;
+		}
+	);
+
+	/*
+	Test that every stencil kernel produces identical results, in single and double precision.
+	*/
+	auto stencilTest = [](auto scalar, const bool& masked) {
+		typedef decltype(scalar) Scalar;
+		const unsigned long Y = 45;
+		std::vector<std::vector<Scalar>> u_b(3, std::vector<Scalar>(Y, 0.));
+		std::vector<std::vector<Scalar>> u_a(3, std::vector<Scalar>(Y, 0.));
+		std::vector<short> B_row(Y, 0);
+		for (unsigned long y = 0; y < Y; y++) {
+			u_b[0][y] = sin(y * 0.1);
+			u_b[1][y] = cos(y * 0.3);
+			u_b[2][y] = sin(y * 0.7) * 0.5;
+			u_a[0][y] = u_a[1][y] = u_a[2][y] = cos(y * 1.1) * 0.25;
+			B_row[y] = (y % 7) != 3 ? 1 : 0;
+		}
+		const std::array<U::SIMDLevel, 3> levels = {
+			U::SIMDLevel::Scalar, U::SIMDLevel::AVX2, U::SIMDLevel::AVX512
+		};
+		for (unsigned long i = 0; i < 3; i++) {
+			p::FDTDStencil<Scalar>(levels[i], masked)(
+				u_a[i].data(),
+				u_b[1].data(),
+				u_b[0].data(),
+				u_b[2].data(),
+				B_row.data(),
+				1,
+				Y - 1,
+				0.3,
+				0.8,
+				0.99
+			);
+		}
+		return u_a[0] == u_a[1] && u_a[0] == u_a[2];
+	};
+	booleanTest(
+		"FDTDStencil kernels produce identical results",
+		stencilTest(0., true) && stencilTest(0., false)
+	);
+	booleanTest(
+		"FDTDStencil kernels produce identical results",
+		stencilTest(0.f, true) && stencilTest(0.f, false)
+	);
+
 	return 0;
 }
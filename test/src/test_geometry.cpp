@@ -4,6 +4,7 @@ Tests for /geometry.
 
 // core
 #include <numbers>
+#include <random>
 using namespace std::numbers;
 
 // src
@@ -33,6 +34,45 @@ int main() {
 		}
 	);
 
+	/*
+	Test that polygons generated in parallel using indexedRandomEngine are reproducible.
+	*/
+	std::vector<T::Polygon> P_batch(64);
+	kac_core::utils::ThreadPool polygon_pool(4);
+	polygon_pool.run([&](const unsigned long& t) {
+		for (unsigned long n = t; n < P_batch.size(); n += polygon_pool.size()) {
+			std::mt19937_64 engine = g::indexedRandomEngine(2, n);
+			P_batch[n] = g::generatePolygon(3 + n % 10, engine);
+		}
+	});
+	batchBooleanTest(
+		"generatePolygon is reproducible for a given indexedRandomEngine",
+		P_batch.size(),
+		[&P_batch](const unsigned long& n) {
+			std::mt19937_64 engine = g::indexedRandomEngine(2, n);
+			T::Polygon P_sequential = g::generatePolygon(3 + n % 10, engine);
+			for (unsigned long i = 0; i < P_sequential.size(); i++) {
+				if (P_batch[n][i].x != P_sequential[i].x || P_batch[n][i].y != P_sequential[i].y) {
+					return false;
+				}
+			}
+			return P_batch[n].size() == P_sequential.size();
+		}
+	);
+
+	std::mt19937_64 convex_engine = g::indexedRandomEngine(2, 7);
+	T::Polygon P_convex_indexed = g::generateConvexPolygon(8, convex_engine);
+	convex_engine = g::indexedRandomEngine(2, 7);
+	T::Polygon P_convex_indexed_copy = g::generateConvexPolygon(8, convex_engine);
+	batchBooleanTest(
+		"generateConvexPolygon is reproducible for a given indexedRandomEngine",
+		8,
+		[&P_convex_indexed, &P_convex_indexed_copy](const unsigned long& n) {
+			return P_convex_indexed[n].x == P_convex_indexed_copy[n].x
+				&& P_convex_indexed[n].y == P_convex_indexed_copy[n].y;
+		}
+	);
+
 	/*
 	Test the properties of generateConvexPolygon.
 	*/
@@ -71,6 +111,17 @@ int main() {
 	// booleanTest(
 	// 	"isPointInsidePolygon holds.", g::isPointInsidePolygon(T::Point(0.5, 0.5), square_clockwise)
 	// );
+	// a NaN vertex is left in the storage beyond the end of the polygon, which would poison the
+	// length of the ray if the loop bound were to read P[N]
+	T::Polygon triangle = {
+		T::Point(0., 0.), T::Point(1., 0.), T::Point(0., 1.), T::Point(NAN, NAN)
+	};
+	triangle.pop_back();
+	booleanTest(
+		"isPointInsidePolygon reads only the vertices of the polygon",
+		g::isPointInsidePolygon(T::Point(0.25, 0.25), triangle)
+			&& !g::isPointInsidePolygon(T::Point(0.75, 0.75), triangle)
+	);
 
 	/*
 	Test that _polygonCentroid works for negative values.
@@ -114,6 +165,136 @@ int main() {
 		"X(4) produces the correct output.", (orthocenter.x == 1.) && (orthocenter.y == 0.)
 	);
 
+	/*
+	Test bresenham.
+	*/
+	T::BooleanImage M_line(50, std::vector<short>(90, 0));
+	T::BitImage M_line_packed(50, 90);
+	for (const T::Line& L:
+		 {T::Line(T::Point(0., 0.), T::Point(1., 1.)),
+		  T::Line(T::Point(0.9, 0.1), T::Point(0.2, 0.7)),
+		  T::Line(T::Point(0.5, 1.), T::Point(0.6, 0.))}) {
+		g::bresenham(M_line, L);
+		g::bresenham(M_line_packed, L);
+	}
+	booleanTest(
+		"bresenham is identical for T::BitImage",
+		M_line_packed.matrix() == M_line && M_line_packed.count() > 90
+	);
+
+	/*
+	Test the polygon rasteriser.
+	*/
+	const unsigned long X_R = 67;
+	const unsigned long Y_R = 45;
+	T::Polygon P_raster = g::normalisePolygon(g::generatePolygon(12, 3));
+	T::BitImage M_raster = g::rasterisePolygon(P_raster, X_R, Y_R);
+	T::BitImage M_conservative =
+		g::rasterisePolygon(P_raster, X_R, Y_R, g::RasterMode::Conservative);
+	T::Matrix_2D C_raster = g::polygonCoverage(P_raster, X_R, Y_R, 16);
+	batchBooleanTest(
+		"rasterisePolygon matches isPointInsidePolygon",
+		X_R,
+		[&](const unsigned long& x) {
+			for (unsigned long y = 0; y < Y_R; y++) {
+				const T::Point p(x / (X_R - 1.), y / (Y_R - 1.));
+				bool on_boundary = false;
+				for (unsigned long n = 0; n < 12; n++) {
+					on_boundary = on_boundary
+							   || g::isPointOnLine(p, T::Line(P_raster[n], P_raster[(n + 1) % 12]));
+				}
+				if (!on_boundary && M_raster(x, y) != g::isPointInsidePolygon(p, P_raster)) {
+					return false;
+				}
+			}
+			return true;
+		}
+	);
+	batchBooleanTest(
+		"conservative rasterisation contains every covered pixel",
+		X_R,
+		[&](const unsigned long& x) {
+			for (unsigned long y = 0; y < Y_R; y++) {
+				if ((M_raster(x, y) || C_raster[x][y] > 0.) && !M_conservative(x, y)) {
+					return false;
+				}
+			}
+			return true;
+		}
+	);
+	double coverage = 0.;
+	for (unsigned long x = 0; x < X_R; x++) {
+		for (unsigned long y = 0; y < Y_R; y++) { coverage += C_raster[x][y]; }
+	}
+	booleanTest(
+		"polygonCoverage integrates to the area of the polygon",
+		abs(coverage / ((X_R - 1.) * (Y_R - 1.)) - g::polygonArea(P_raster)) < 1e-3
+	);
+
+	/*
+	Test classifyIntersection.
+	*/
+	const std::array<std::pair<T::Line, g::IntersectionType>, 6> intersections = {
+		std::make_pair(T::Line(T::Point(1., 0.), T::Point(0., 1.)), g::IntersectionType::Intersect),
+		std::make_pair(T::Line(T::Point(1., 1.), T::Point(2., 0.)), g::IntersectionType::Vertex),
+		std::make_pair(
+			T::Line(T::Point(0.5, 0.5), T::Point(1., 0.)), g::IntersectionType::Adjacent
+		),
+		std::make_pair(
+			T::Line(T::Point(0.5, 0.5), T::Point(2., 2.)), g::IntersectionType::Colinear
+		),
+		std::make_pair(T::Line(T::Point(2., 2.), T::Point(3., 3.)), g::IntersectionType::None),
+		std::make_pair(T::Line(T::Point(0., 1.), T::Point(1., 2.)), g::IntersectionType::None),
+	};
+	batchBooleanTest("classifyIntersection is accurate", 6, [&](const unsigned long& i) {
+		const T::Line diagonal = T::Line(T::Point(0., 0.), T::Point(1., 1.));
+		return g::classifyIntersection(diagonal, intersections[i].first).first
+				== intersections[i].second
+			&& g::lineIntersection(diagonal, intersections[i].first).first
+				   == std::array<std::string, 6>(
+					   {"intersect", "vertex", "adjacent", "colinear", "none", "none"}
+				   )[i];
+	});
+
+	/*
+	Test isSimple.
+	*/
+	std::mt19937 simple_engine(7);
+	batchBooleanTest(
+		"isSimple is identical to isSimpleBruteForce",
+		20000,
+		[&](const unsigned long& i) {
+			// integer coordinates produce shared vertices and colinear edges
+			const unsigned long grid = i % 2 == 0 ? 6 : 1000;
+			T::Polygon P_simple(3 + simple_engine() % 8);
+			for (T::Point& p: P_simple) {
+				p = T::Point(simple_engine() % grid, simple_engine() % grid);
+			}
+			return g::isSimple(P_simple) == g::isSimpleBruteForce(P_simple);
+		}
+	);
+	batchBooleanTest(
+		"generatePolygon is identical to generatePolygonBruteForce",
+		60,
+		[](const unsigned long& i) {
+			std::mt19937_64 engine = g::indexedRandomEngine(11, i);
+			std::mt19937_64 engine_copy = engine;
+			const unsigned long N_polygon = 3 + i % 6 * 8;
+			T::Polygon P_fast = g::generatePolygon(N_polygon, engine);
+			T::Polygon P_brute = g::generatePolygonBruteForce(N_polygon, engine_copy);
+			for (unsigned long n = 0; n < N_polygon; n++) {
+				if (P_fast[n].x != P_brute[n].x || P_fast[n].y != P_brute[n].y) {
+					return false;
+				}
+			}
+			return P_fast.size() == P_brute.size();
+		}
+	);
+	booleanTest("isSimple holds for generatePolygon", g::isSimple(g::generatePolygon(40, 5)));
+	booleanTest(
+		"isSimple holds for a large generatePolygon", g::isSimple(g::generatePolygon(400, 5))
+	);
+
 	/*
 	Test isPointOnLine is accurate.
 	*/
@@ -4,15 +4,23 @@ Tests for /modes.
 
 // core
 #include <math.h>
+#include <cstdio>
+#include <numbers>
+#include <string>
 
 // src
 #include <kac_core.hpp>
 namespace p = kac_core::physics;
+namespace U = kac_core::utils;
 
 // test
 #include "./utils.hpp"
 
 int main() {
+	const std::array<U::SIMDLevel, 3> levels = {
+		U::SIMDLevel::Scalar, U::SIMDLevel::AVX2, U::SIMDLevel::AVX512
+	};
+
 	/*
 	Test Bessel function.
 	*/
@@ -21,10 +29,315 @@ int main() {
 		abs(p::besselJ(0, 4.2) - -0.37655) < 0.001 && abs(p::besselJ(1, 1.2) - 0.498289) < 0.001
 	);
 
+	/*
+	Test the batch bessel function.
+	*/
+	T::Matrix_1D x_bessel;
+	for (double x = 0.; x < 120.; x += 0.37) { x_bessel.push_back(x); }
+	T::Matrix_2D J_batch = p::besselJBatch(40, x_bessel);
+	batchBooleanTest(
+		"besselJBatch is accurate", x_bessel.size(), [&](const unsigned long& i) {
+			for (long n = 0; n < 40; n++) {
+				if (abs(J_batch[i][n] - p::besselJ(n, x_bessel[i])) > pow(2., -48.)) {
+					return false;
+				}
+			}
+			return true;
+		}
+	);
+	booleanTest(
+		"besselJBatch returns an empty row per argument when N = 0",
+		p::besselJBatch(0, {1., 2.}) == T::Matrix_2D(2)
+	);
+	for (const U::SIMDLevel& level: levels) {
+		p::BesselJBatch(level)(x_bessel.data(), x_bessel.size(), 0, nullptr);
+	}
+	T::Matrix_2D J_far = p::besselJBatch(4, {450.3, -1e6});
+	booleanTest(
+		"besselJBatch falls back to boost beyond the measured range",
+		J_far[0][3] == boost::math::cyl_bessel_j(3., 450.3)
+			&& J_far[1][2] == boost::math::cyl_bessel_j(2., -1e6)
+	);
+	booleanTest("besselJBatch rejects non-finite arguments", [&]() {
+		try {
+			p::besselJBatch(4, {1., INFINITY});
+		} catch (const std::invalid_argument&) {
+			return true;
+		}
+		return false;
+	}());
+	std::array<T::Matrix_1D, 3> J_levels;
+	for (unsigned long i = 0; i < 3; i++) {
+		J_levels[i].resize(x_bessel.size() * 40);
+		p::BesselJBatch(levels[i])(x_bessel.data(), x_bessel.size(), 40, J_levels[i].data());
+	}
+	booleanTest(
+		"BesselJBatch kernels produce identical results",
+		J_levels[0] == J_levels[1] && J_levels[0] == J_levels[2]
+	);
+
+	/*
+	Test the bessel zero table.
+	*/
+	booleanTest(
+		"besselZeroTable is identical to besselJZero",
+		p::circularSeries(5, 7)[3][4] == boost::math::cyl_bessel_j_zero(3., 5)
+			&& p::besselJZero(2., 9) == boost::math::cyl_bessel_j_zero(2., 9)
+	);
+	const std::string cache = "test_modes_bessel_zeros.bin";
+	p::BesselZeroTable table;
+	booleanTest(
+		"BesselZeroTable stores and loads its cache file",
+		!table.load(cache) && table.save(cache, 6, 4) && table.load(cache)
+			&& table.zeros(8, 6) == p::circularSeries(8, 6)
+	);
+	std::FILE* crafted = std::fopen(cache.c_str(), "wb");
+	const std::uint64_t crafted_size[2] = {1ull << 62, 4};
+	std::fwrite("KACBZT01", 1, 8, crafted);
+	std::fwrite(crafted_size, sizeof(std::uint64_t), 2, crafted);
+	std::fclose(crafted);
+	booleanTest("BesselZeroTable rejects a cache file that overflows its size", !table.load(cache));
+	std::remove(cache.c_str());
+	booleanTest("BesselZeroTable rejects m < 1", [&]() {
+		try {
+			table.zero(2, 0);
+		} catch (const std::invalid_argument&) {
+			return true;
+		}
+		return false;
+	}());
+
+	/*
+	Test the circular chladni pattern.
+	*/
+	batchBooleanTest(
+		"circularChladniPattern matches the direct evaluation away from the tolerance",
+		6,
+		[&](const unsigned long& i) {
+			const double n = std::array<double, 6>({0., 1., 2.5, 3., 4.2, 7.})[i];
+			const double m = 1. + 0.7 * i;
+			const unsigned long H = 101;
+			const double z_floor = p::besselJZero(n, floor(m));
+			const double z_mn = z_floor + (p::besselJZero(n, ceil(m)) - z_floor) * (m - floor(m));
+			T::BooleanImage M = p::circularChladniPattern(n, m, H);
+			for (unsigned long x = 0; x < H; x++) {
+				for (unsigned long y = 0; y < H; y++) {
+					const double x_prime = (2. * x / H) - 1.;
+					const double y_prime = (2. * y / H) - 1.;
+					const double r = sqrt(pow(x_prime, 2) + pow(y_prime, 2));
+					const double theta = atan2(y_prime, x_prime);
+					const double n_round = round(2. * n) / 2.;
+					const double v = r > 1.
+									   ? 1.
+									   : abs(boost::math::cyl_bessel_j(n, z_mn * r)
+											 * (cos(n_round * theta) + sin(n_round * theta)));
+					if (abs(v - 0.1) > 1e-6 && M[x][y] != (v < 0.1 ? 1 : 0)) {
+						return false;
+					}
+				}
+			}
+			return true;
+		}
+	);
+
+	/*
+	Test the rectangular chladni pattern.
+	*/
+	const unsigned long X_R = 70;
+	const unsigned long Y_R = 133;
+	T::BooleanImage M_R = p::rectangularChladniPattern(3., 5., X_R, Y_R);
+	batchBooleanTest(
+		"rectangularChladniPattern is identical to the direct evaluation",
+		X_R,
+		[&](const unsigned long& x) {
+			for (unsigned long y = 0; y < Y_R; y++) {
+				const double v = abs(
+					(cos(3. * std::numbers::pi * x / X_R) * cos(5. * std::numbers::pi * y / Y_R))
+					- (cos(5. * std::numbers::pi * x / X_R) * cos(3. * std::numbers::pi * y / Y_R))
+				);
+				if (M_R[x][y] != (v < 0.1 ? 1 : 0)) {
+					return false;
+				}
+			}
+			return true;
+		}
+	);
+	T::Matrix_1D u_nodal(Y_R);
+	T::Matrix_1D v_nodal(Y_R);
+	for (unsigned long y = 0; y < Y_R; y++) {
+		u_nodal[y] = sin(0.3 * y);
+		v_nodal[y] = cos(0.7 * y);
+	}
+	std::array<std::array<std::uint64_t, 3>, 3> bits_nodal;
+	for (unsigned long i = 0; i < 3; i++) {
+		p::NodalRow(levels[i])(
+			0.6, 0.4, u_nodal.data(), v_nodal.data(), Y_R, 0.2, bits_nodal[i].data()
+		);
+	}
+	booleanTest(
+		"NodalRow kernels produce identical results",
+		bits_nodal[0] == bits_nodal[1] && bits_nodal[0] == bits_nodal[2]
+	);
+
 	/*
 	Test linear modes.
 	*/
 	booleanTest("the 0th element from linearSeries is 1", p::linearSeries(10)[0] == 1);
 
+	/*
+	Test the batch amplitude functions.
+	*/
+	const unsigned long K = 13;
+	const unsigned long N_A = 12;
+	const unsigned long M_A = 9;
+	T::Matrix_1D s_0(K);
+	T::Matrix_1D s_1(K);
+	T::Matrix_1D s_2(K);
+	for (unsigned long k = 0; k < K; k++) {
+		s_0[k] = (k + 0.5) / K;
+		s_1[k] = 0.3 + 0.05 * k;
+		s_2[k] = 1. - s_0[k] * 0.5 - s_1[k] * 0.5;
+	}
+	T::Matrix_1D A_batch(K * N_A * M_A);
+	p::linearAmplitudesBatch(s_0, N_A, A_batch.data());
+	batchBooleanTest("linearAmplitudesBatch is accurate", K, [&](const unsigned long& k) {
+		T::Matrix_1D A_k = p::linearAmplitudes(s_0[k], N_A);
+		for (unsigned long n = 0; n < N_A; n++) {
+			if (abs(A_batch[k * N_A + n] - A_k[n]) > N_A * pow(2., -50.)) {
+				return false;
+			}
+		}
+		return true;
+	});
+	auto batchTest = [&](const std::string& name,
+						 const std::function<T::Matrix_2D(const unsigned long&)>& f) {
+		batchBooleanTest(name, K, [&](const unsigned long& k) {
+			T::Matrix_2D A_k = f(k);
+			for (unsigned long n = 0; n < N_A; n++) {
+				for (unsigned long m = 0; m < M_A; m++) {
+					if (abs(A_batch[(k * N_A + n) * M_A + m] - A_k[n][m])
+						> 2 * (N_A + M_A) * pow(2., -50.)) {
+						return false;
+					}
+				}
+			}
+			return true;
+		});
+	};
+	p::rectangularAmplitudesBatch(s_0, s_1, N_A, M_A, 1.3, A_batch.data());
+	batchTest("rectangularAmplitudesBatch is accurate", [&](const unsigned long& k) {
+		return p::rectangularAmplitudes(s_0[k], s_1[k], N_A, M_A, 1.3);
+	});
+	p::equilateralTriangleAmplitudesBatch(s_0, s_1, s_2, N_A, M_A, A_batch.data());
+	batchTest("equilateralTriangleAmplitudesBatch is accurate", [&](const unsigned long& k) {
+		return p::equilateralTriangleAmplitudes(s_0[k], s_1[k], s_2[k], N_A, M_A);
+	});
+	booleanTest(
+		"equilateralTriangleOrderAmplitudes is broadcast by WaveEquationWaveform2D",
+		p::WaveEquationWaveform2D(
+			p::equilateralTriangleSeries(N_A, M_A),
+			p::equilateralTriangleOrderAmplitudes(0.2, 0.3, 0.5, N_A),
+			-1e-3,
+			1e-4,
+			500
+		) == p::WaveEquationWaveform2D(
+			p::equilateralTriangleSeries(N_A, M_A),
+			p::equilateralTriangleAmplitudes(0.2, 0.3, 0.5, N_A, M_A),
+			-1e-3,
+			1e-4,
+			500
+		)
+	);
+	const T::Matrix_2D S_circle = p::circularSeries(N_A, M_A);
+	p::circularAmplitudesBatch(s_0, s_1, S_circle, A_batch.data());
+	batchTest("circularAmplitudesBatch is accurate", [&](const unsigned long& k) {
+		return p::circularAmplitudes(s_0[k], s_1[k], S_circle);
+	});
+
+	/*
+	Test the oscillator bank.
+	*/
+	const unsigned long N = 7;
+	const unsigned long M = 5;
+	const unsigned long T = 5000;
+	const double d = -1e-4;
+	const double k = 1. / 48000.;
+	T::Matrix_2D F(N, T::Matrix_1D(M));
+	T::Matrix_2D A(N, T::Matrix_1D(M));
+	for (unsigned long n = 0; n < N; n++) {
+		for (unsigned long m = 0; m < M; m++) {
+			F[n][m] = 100. * (n + 1) + 37. * m * m;
+			A[n][m] = 1. / (n + m + 1);
+		}
+	}
+	T::Matrix_1D waveform = p::WaveEquationWaveform2D(F, A, d, k, T);
+	batchBooleanTest(
+		"WaveEquationWaveform2D is within its documented tolerance of the closed form",
+		T,
+		[&](const unsigned long& t) {
+			double w = 0.;
+			for (unsigned long n = 0; n < N; n++) {
+				for (unsigned long m = 0; m < M; m++) {
+					w += A[n][m] * pow(std::numbers::e, t * d)
+					   * sin(t * F[n][m] * (2 * std::numbers::pi * k)) / (N * M);
+				}
+			}
+			const double omega_max =
+				(100. * N + 37. * (M - 1) * (M - 1)) * (2 * std::numbers::pi * k);
+			return abs(waveform[t] - w)
+				<= (1024 + t * omega_max) * pow(2., -50.) * pow(std::numbers::e, t * d);
+		}
+	);
+	T::Matrix_2D F_alias = F;
+	F_alias[0][0] = 24000.;
+	F_alias[1][0] = 30000.;
+	T::Matrix_2D A_quiet = A;
+	A_quiet[2][0] = 1e-6;
+	booleanTest(
+		"pruneModes discards modes above nyquist and below the threshold",
+		p::pruneModes(F_alias, A, k).omega.size() == N * M - 2
+			&& p::pruneModes(F, A_quiet, k, 1e-3).omega.size() == N * M - 1
+			&& p::pruneModes(F, A, k).amplitude[0] == A[0][0] / (N * M)
+	);
+	T::Matrix_2D A_negative = A;
+	for (T::Matrix_1D& row: A_negative) {
+		for (double& a: row) { a = -a; }
+	}
+	booleanTest(
+		"pruneModes normalises signed amplitudes by max(|A|)",
+		p::pruneModes(F, A_negative, k, 1e-3).omega.size() == N * M
+			&& p::pruneModes(F, A_negative, k).amplitude[0] == -A[0][0] / (N * M)
+	);
+	T::Matrix_1D waveform_pruned = p::WaveEquationWaveform2D(F, A, -1e-2, k, T, 1e-3, 1e-3);
+	booleanTest(
+		"WaveEquationWaveform2D is silent once decayed below the threshold",
+		waveform_pruned[690] != 0. && waveform_pruned[691] == 0. && waveform_pruned[T - 1] == 0.
+	);
+
+	U::ThreadPool pool(4);
+	T::Matrix_1D waveform_long = p::WaveEquationWaveform2D(F, A, d, k, 20000);
+	T::Matrix_1D waveform_parallel = p::WaveEquationWaveform2D(F, A, d, k, 20000, 0., 0., pool);
+	booleanTest(
+		"WaveEquationWaveform2D is identical when multithreaded",
+		waveform_long == waveform_parallel
+	);
+
+	T::Matrix_1D omega(37);
+	T::Matrix_1D amplitude(37);
+	for (unsigned long i = 0; i < 37; i++) {
+		omega[i] = 0.08 * i + 0.01;
+		amplitude[i] = 1. / (i + 1);
+	}
+	std::array<T::Matrix_1D, 3> banks;
+	for (unsigned long i = 0; i < 3; i++) {
+		banks[i].resize(3000);
+		p::ModalOscillatorBank(omega, amplitude, -1e-4, 256, levels[i])
+			.process(banks[i].data(), 3000);
+	}
+	booleanTest(
+		"ModalOscillatorBank kernels produce identical results",
+		banks[0] == banks[1] && banks[0] == banks[2]
+	);
+
 	return 0;
 }